@@ -0,0 +1,165 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+//###########################################################################
+//#
+//#                        Benchmark Harness
+//#
+//############################################################################
+
+//a minimal, self contained micro benchmark harness
+//every benchmark is a function that receives a State and calls one of the measure functions
+//the results are written as JSON, so they can be compared between releases
+namespace bench
+{
+	//prevents the compiler from optimizing away a computed value
+	template<typename T>
+	inline void doNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	struct Result
+	{
+		std::string name;
+		size_t iterations = 0;
+		double totalNs = 0.;
+
+		double nsPerOp() const noexcept
+		{
+			return iterations ? totalNs / static_cast<double>(iterations) : 0.;
+		}
+	};
+
+	class State
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		State(std::string name, Clock::duration minTime)
+			: m_minTime(minTime)
+		{
+			m_result.name = std::move(name);
+		}
+
+		//measures an operation without any per batch setup, the batch size is calibrated
+		//op gets called with the index of the iteration
+		template<typename OpT>
+		void measure(OpT&& op)
+		{
+			size_t batchSize = 1;
+			Clock::duration elapsed{};
+			size_t iterations = 0;
+			while (elapsed < m_minTime)
+			{
+				const auto start = Clock::now();
+				for (size_t i = 0; i < batchSize; ++i)
+					op(iterations + i);
+				elapsed += Clock::now() - start;
+				iterations += batchSize;
+				batchSize *= 2;
+			}
+			record(iterations, elapsed);
+		}
+
+		//measures batches of batchSize operations, each batch works on a fresh fixture
+		//creating and destroying the fixture is not part of the measurement
+		template<typename SetupT, typename OpT>
+		void measureBatches(size_t batchSize, SetupT&& setup, OpT&& op)
+		{
+			Clock::duration elapsed{};
+			size_t iterations = 0;
+			while (elapsed < m_minTime)
+			{
+				auto fixture = setup();
+				const auto start = Clock::now();
+				for (size_t i = 0; i < batchSize; ++i)
+					op(fixture, i);
+				elapsed += Clock::now() - start;
+				iterations += batchSize;
+			}
+			record(iterations, elapsed);
+		}
+
+		const Result& getResult() const noexcept
+		{
+			return m_result;
+		}
+
+	private:
+		void record(size_t iterations, Clock::duration elapsed)
+		{
+			m_result.iterations = iterations;
+			m_result.totalNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+		}
+
+		Clock::duration m_minTime;
+		Result m_result;
+	};
+
+	struct Benchmark
+	{
+		std::string name;
+		std::function<void(State&)> func;
+	};
+
+	inline std::vector<Benchmark>& registry()
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	struct Registrar
+	{
+		Registrar(std::string name, std::function<void(State&)> func)
+		{
+			registry().push_back({ std::move(name), std::move(func) });
+		}
+	};
+
+	inline void writeJson(std::ostream& out, const std::vector<Result>& results, const std::string& version)
+	{
+		out << "{\n  \"context\": {\n";
+		out << "    \"library_version\": \"" << version << "\",\n";
+#if defined(__clang__)
+		out << "    \"compiler\": \"clang " << __clang_major__ << "." << __clang_minor__ << "\",\n";
+#elif defined(__GNUC__)
+		out << "    \"compiler\": \"gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "\",\n";
+#elif defined(_MSC_VER)
+		out << "    \"compiler\": \"msvc " << _MSC_VER << "\",\n";
+#else
+		out << "    \"compiler\": \"unknown\",\n";
+#endif
+#ifdef NDEBUG
+		out << "    \"build_type\": \"release\"\n";
+#else
+		out << "    \"build_type\": \"debug\"\n";
+#endif
+		out << "  },\n  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+			char nsPerOp[64];
+			std::snprintf(nsPerOp, sizeof(nsPerOp), "%.3f", result.nsPerOp());
+			out << "    { \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+				<< ", \"total_ns\": " << static_cast<unsigned long long>(result.totalNs)
+				<< ", \"ns_per_op\": " << nsPerOp << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+		}
+		out << "  ]\n}\n";
+	}
+}
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+#define BENCHMARK(name, func) static bench::Registrar BENCH_CONCAT(s_benchRegistrar, __LINE__)(name, func)
@@ -0,0 +1,776 @@
+#include "BenchmarkHarness.h"
+
+#include <cppproperties/ChangeJournal.h>
+#include <cppproperties/ConcurrentReads.h>
+#include <cppproperties/PropertyContainer.h>
+#include <cppproperties/PropertyIngestor.h>
+#include <cppproperties/SharedPropertyPublisher.h>
+#include <cppproperties/ProxyProperty.h>
+#include <cppproperties/Snapshot.h>
+#include <cppproperties/StaticPropertyContainer.h>
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <thread>
+#include <string>
+#include <vector>
+
+#ifndef CPPPROPERTIES_VERSION
+#define CPPPROPERTIES_VERSION "unknown"
+#endif
+
+namespace
+{
+	ps::PropertyDescriptor<int> IntPD(0);
+	ps::PropertyDescriptor<int> OtherIntPD(0);
+	ps::PropertyDescriptor<float> FloatPD(0.f);
+	ps::PropertyDescriptor<std::string> StringPD("Empty");
+	ps::PropertyDescriptor<int> SumPD(0);
+
+	class ObserverContainer : public ps::PropertyContainer
+	{
+	public:
+		void onIntChanged(int value)
+		{
+			m_value += value;
+		}
+		int m_value = 0;
+	};
+
+	//builds a chain of depth containers below the root and returns the deepest one
+	ps::PropertyContainer& buildChain(ps::PropertyContainer& root, size_t depth)
+	{
+		ps::PropertyContainer* current = &root;
+		for (size_t i = 0; i < depth; ++i)
+			current = &current->addChildContainer<ps::PropertyContainer>();
+		return *current;
+	}
+
+	//builds a root with width observer children, half of them connect a lambda the other half a PMF
+	std::unique_ptr<ps::PropertyContainer> buildObservedTree(size_t width, int& lambdaSink)
+	{
+		auto root = std::make_unique<ps::PropertyContainer>();
+		root->setProperty(IntPD, 0);
+		for (size_t i = 0; i < width; ++i)
+		{
+			auto& child = root->addChildContainer<ObserverContainer>();
+			if (i % 2)
+				child.connect(IntPD, &ObserverContainer::onIntChanged);
+			else
+				child.connect(IntPD, [&lambdaSink](int value) { lambdaSink += value; });
+		}
+		return root;
+	}
+
+	//###########################################################################
+	//#
+	//#                        Property
+	//#
+	//############################################################################
+
+	void propertySet(bench::State& state)
+	{
+		ps::Property<int> property;
+		state.measure([&](size_t i) { property.set(static_cast<int>(i)); });
+		bench::doNotOptimize(property.get());
+	}
+	BENCHMARK("Property::set", propertySet);
+
+	void propertySetConnected(bench::State& state)
+	{
+		ps::Property<int> property;
+		int sink = 0;
+		property.connect([&sink](int value) { sink += value; });
+		state.measure([&](size_t i) { property.set(static_cast<int>(i)); });
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("Property::set/connected", propertySetConnected);
+
+	//a large value that differs in the last element only, so the comparison has to look at all of it
+	template<bool AlwaysChanged>
+	void propertySetBuffer(bench::State& state)
+	{
+		ps::AlwaysChangedPolicy<std::vector<float>> policy;
+		ps::Property<std::vector<float>> property(std::vector<float>(4096, 1.f));
+		if constexpr (AlwaysChanged)
+			property.setChangePolicy(&policy);
+		std::vector<float> buffers[2] = { std::vector<float>(4096, 1.f), std::vector<float>(4096, 1.f) };
+		buffers[1].back() = 2.f;
+		state.measure([&](size_t i) {
+			//the copy reuses the capacity of the property, so only the comparison and the copy are measured
+			property.set(buffers[i & 1]);
+		});
+	}
+	BENCHMARK("Property::set/buffer4096/compare", propertySetBuffer<false>);
+	BENCHMARK("Property::set/buffer4096/alwaysChanged", propertySetBuffer<true>);
+
+	//###########################################################################
+	//#
+	//#                        set, change, get
+	//#
+	//############################################################################
+
+	void containerSetProperty(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		state.measure([&](size_t i) { root.setProperty(IntPD, static_cast<int>(i)); });
+		bench::doNotOptimize(root.getProperty(IntPD));
+	}
+	BENCHMARK("PropertyContainer::setProperty", containerSetProperty);
+
+	void containerChangeProperty(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 0);
+		state.measure([&](size_t i) { root.changeProperty(IntPD, static_cast<int>(i)); });
+		bench::doNotOptimize(root.getProperty(IntPD));
+	}
+	BENCHMARK("PropertyContainer::changeProperty", containerChangeProperty);
+
+	//posting is measured together with applying the posted changes in batches of 1024
+	void containerPostChange(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		auto& child = root.addChildContainer<ps::PropertyContainer>();
+		child.setProperty(IntPD, 0);
+		state.measure([&](size_t i) {
+			child.postChange(IntPD, static_cast<int>(i));
+			if ((i & 1023) == 1023)
+				root.emit();
+		});
+		root.emit();
+		bench::doNotOptimize(child.getProperty(IntPD));
+	}
+	BENCHMARK("PropertyContainer::postChange", containerPostChange);
+
+	template<size_t Depth>
+	void containerGetProperty(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 42);
+		auto& leaf = buildChain(root, Depth);
+		state.measure([&](size_t) { bench::doNotOptimize(leaf.getProperty(IntPD)); });
+	}
+	BENCHMARK("PropertyContainer::getProperty/depth:0", containerGetProperty<0>);
+	BENCHMARK("PropertyContainer::getProperty/depth:4", containerGetProperty<4>);
+	BENCHMARK("PropertyContainer::getProperty/depth:16", containerGetProperty<16>);
+	BENCHMARK("PropertyContainer::getProperty/depth:64", containerGetProperty<64>);
+
+	template<size_t Depth>
+	void containerHandleGet(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 42);
+		auto& leaf = buildChain(root, Depth);
+		auto handle = leaf.handle(IntPD);
+		state.measure([&](size_t) { bench::doNotOptimize(handle.get()); });
+	}
+	BENCHMARK("PropertyHandle::get/depth:4", containerHandleGet<4>);
+	BENCHMARK("PropertyHandle::get/depth:64", containerHandleGet<64>);
+
+	void staticContainerGetProperty(bench::State& state)
+	{
+		ps::StaticPropertyContainer<IntPD, FloatPD> container;
+		container.set<IntPD>(42);
+		state.measure([&](size_t) { bench::doNotOptimize(container.getProperty(IntPD)); });
+	}
+	BENCHMARK("StaticPropertyContainer::getProperty", staticContainerGetProperty);
+
+	//###########################################################################
+	//#
+	//#                        connect and emit
+	//#
+	//############################################################################
+
+	void containerConnect(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 0);
+		auto& leaf = buildChain(root, 4);
+		int sink = 0;
+		//connect and disconnect, otherwise the signal would grow unbounded
+		state.measure([&](size_t) {
+			const auto idx = leaf.connect(IntPD, [&sink](int value) { sink += value; });
+			leaf.disconnect(IntPD, idx);
+		});
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("PropertyContainer::connect+disconnect", containerConnect);
+
+	template<bool IgnoreDuplicateCalls>
+	void containerEmit(bench::State& state)
+	{
+		int sink = 0;
+		auto root = buildObservedTree(64, sink);
+		state.measure([&](size_t i) {
+			root->changeProperty(IntPD, static_cast<int>(i + 1));
+			root->emit(IgnoreDuplicateCalls);
+		});
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("PropertyContainer::emit/ignoreDuplicateCalls:true/children:64", containerEmit<true>);
+	BENCHMARK("PropertyContainer::emit/ignoreDuplicateCalls:false/children:64", containerEmit<false>);
+
+	//a big hierarchy where only a few containers change per frame
+	void containerEmitSparse(bench::State& state)
+	{
+		constexpr size_t containerCount = 10000;
+		constexpr size_t changesPerFrame = 16;
+		ps::PropertyContainer root;
+		std::vector<ObserverContainer*> containers;
+		containers.reserve(containerCount);
+		for (size_t i = 0; i < containerCount / 10; ++i)
+		{
+			auto& group = root.addChildContainer<ObserverContainer>();
+			containers.push_back(&group);
+			for (size_t j = 0; j < 9; ++j)
+				containers.push_back(&group.addChildContainer<ObserverContainer>());
+		}
+		for (auto* container : containers)
+		{
+			container->setProperty(OtherIntPD, 0);
+			container->connect(OtherIntPD, &ObserverContainer::onIntChanged);
+		}
+		root.emit();
+		state.measure([&](size_t i) {
+			for (size_t j = 0; j < changesPerFrame; ++j)
+				containers[(i * changesPerFrame + j) * 7919 % containerCount]->changeProperty(OtherIntPD, static_cast<int>(i + 1));
+			root.emit();
+		});
+	}
+	BENCHMARK("PropertyContainer::emit/sparse/containers:10000/changes:16", containerEmitSparse);
+
+	//independent subtrees with expensive callbacks, emitted sequentially or on a thread pool
+	template<bool Parallel>
+	void containerEmitSubtrees(bench::State& state)
+	{
+		constexpr size_t subtreeCount = 8;
+		ps::ThreadPool threadPool;
+		ps::PropertyContainer root;
+		std::vector<ps::PropertyContainer*> heads;
+		std::vector<double> sinks(subtreeCount);
+		for (size_t i = 0; i < subtreeCount; ++i)
+		{
+			auto& head = root.addChildContainer<ps::PropertyContainer>();
+			head.setIndependentSubtree();
+			head.setProperty(OtherIntPD, 0);
+			for (size_t j = 0; j < 16; ++j)
+			{
+				head.addChildContainer<ps::PropertyContainer>().connect(OtherIntPD, [&sink = sinks[i]](int value) {
+					for (int k = 0; k < 2000; ++k)
+						sink += static_cast<double>(value) / (k + 1);
+				});
+			}
+			heads.push_back(&head);
+		}
+		root.emit();
+		state.measure([&](size_t i) {
+			for (auto* head : heads)
+				head->changeProperty(OtherIntPD, static_cast<int>(i + 1));
+			if constexpr (Parallel)
+				root.emit(threadPool);
+			else
+				root.emit();
+		});
+		bench::doNotOptimize(sinks);
+	}
+	BENCHMARK("PropertyContainer::emit/subtrees:8/sequential", containerEmitSubtrees<false>);
+	BENCHMARK("PropertyContainer::emit/subtrees:8/threadPool", containerEmitSubtrees<true>);
+
+	//###########################################################################
+	//#
+	//#                        hierarchy
+	//#
+	//############################################################################
+
+	//every batch starts with a fresh root, so the size of the tree stays bounded
+	constexpr size_t s_treeBatchSize = 1000;
+
+	void addChildContainerWide(bench::State& state)
+	{
+		state.measureBatches(s_treeBatchSize,
+			[] {
+				auto root = std::make_unique<ps::PropertyContainer>();
+				root->setProperty(IntPD, 1);
+				root->setProperty(StringPD, "root");
+				return root;
+			},
+			[](std::unique_ptr<ps::PropertyContainer>& root, size_t) {
+				auto& child = root->addChildContainer<ObserverContainer>();
+				child.connect(IntPD, &ObserverContainer::onIntChanged);
+			});
+	}
+	BENCHMARK("PropertyContainer::addChildContainer/wide", addChildContainerWide);
+
+	struct ChainFixture
+	{
+		std::unique_ptr<ps::PropertyContainer> m_root = std::make_unique<ps::PropertyContainer>();
+		ps::PropertyContainer* m_leaf = m_root.get();
+	};
+
+	void addChildContainerDeep(bench::State& state)
+	{
+		state.measureBatches(s_treeBatchSize,
+			[] {
+				ChainFixture fixture;
+				fixture.m_root->setProperty(IntPD, 1);
+				fixture.m_root->setProperty(StringPD, "root");
+				return fixture;
+			},
+			[](ChainFixture& fixture, size_t) {
+				auto& child = fixture.m_leaf->addChildContainer<ObserverContainer>();
+				child.connect(IntPD, &ObserverContainer::onIntChanged);
+				fixture.m_leaf = &child;
+			});
+	}
+	BENCHMARK("PropertyContainer::addChildContainer/deep", addChildContainerDeep);
+
+	//a configuration of 256 properties is set on a container at depth 8, all of them are observed
+	//by 16 children below and by 48 containers in another branch of the hierarchy
+	constexpr size_t s_configSize = 256;
+	std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> makeConfigPDs()
+	{
+		std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> pds;
+		for (size_t i = 0; i < s_configSize; ++i)
+			pds.push_back(std::make_unique<ps::PropertyDescriptor<int>>(0));
+		return pds;
+	}
+	const auto ConfigPDs = makeConfigPDs();
+
+	struct ConfigFixture
+	{
+		std::unique_ptr<ps::PropertyContainer> m_root = std::make_unique<ps::PropertyContainer>();
+		ps::PropertyContainer* m_target = nullptr;
+	};
+	int s_configSink = 0;
+
+	void observeConfig(ps::PropertyContainer& parent, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			auto& child = parent.addChildContainer<ps::PropertyContainer>();
+			for (const auto& pd : ConfigPDs)
+				child.connect(*pd, [](int value) { s_configSink += value; });
+		}
+	}
+
+	template<bool IsBatched>
+	void setPropertyConfig(bench::State& state)
+	{
+		state.measureBatches(1,
+			[] {
+				ConfigFixture fixture;
+				fixture.m_target = &buildChain(*fixture.m_root, 8);
+				observeConfig(*fixture.m_target, 16);
+				observeConfig(buildChain(*fixture.m_root, 8), 48);
+				return fixture;
+			},
+			[](ConfigFixture& fixture, size_t) {
+				auto& target = *fixture.m_target;
+				auto batch = IsBatched ? std::optional<ps::PropertyContainer::Batch>(target.batch()) : std::nullopt;
+				for (const auto& pd : ConfigPDs)
+					target.setProperty(*pd, 1);
+			});
+	}
+	BENCHMARK("PropertyContainer::setProperty/config256", setPropertyConfig<false>);
+	BENCHMARK("PropertyContainer::batch/config256", setPropertyConfig<true>);
+
+	//moves an observing child back and forth between two parents with 1000 children each
+	void reparentWide(bench::State& state)
+	{
+		int sink = 0;
+		auto root = std::make_unique<ps::PropertyContainer>();
+		root->setProperty(IntPD, 0);
+		auto& parentA = root->addChildContainer<ps::PropertyContainer>();
+		auto& parentB = root->addChildContainer<ps::PropertyContainer>();
+		parentB.setProperty(IntPD, 1);
+		for (size_t i = 0; i < 1000; ++i)
+		{
+			parentA.addChildContainer<ObserverContainer>().connect(IntPD, &ObserverContainer::onIntChanged);
+			parentB.addChildContainer<ObserverContainer>().connect(IntPD, &ObserverContainer::onIntChanged);
+		}
+		auto& child = parentA.addChildContainer<ps::PropertyContainer>();
+		child.connect(IntPD, [&sink](int value) { sink += value; });
+		state.measure([&](size_t i) {
+			if (i % 2)
+				parentB.reparent(child, parentA);
+			else
+				parentA.reparent(child, parentB);
+		});
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("PropertyContainer::reparent/wide", reparentWide);
+
+	//builds and tears down a scene of 64 containers with 4 properties each, optionally from an arena
+	template<bool IsArena>
+	void buildScene(bench::State& state)
+	{
+		std::pmr::monotonic_buffer_resource arena;
+		state.measure([&](size_t i) {
+			{
+				auto root = IsArena ? std::make_unique<ps::PropertyContainer>(&arena) : std::make_unique<ps::PropertyContainer>();
+				root->setProperty(IntPD, static_cast<int>(i));
+				for (size_t child = 0; child < 64; ++child)
+				{
+					auto& container = root->addChildContainer<ps::PropertyContainer>();
+					container.setProperty(OtherIntPD, 1);
+					container.setProperty(FloatPD, 2.f);
+					container.setProperty(StringPD, "child");
+					container.setProperty(SumPD, 3);
+				}
+			}
+			arena.release();
+		});
+	}
+	BENCHMARK("PropertyContainer::buildScene/heap", buildScene<false>);
+	BENCHMARK("PropertyContainer::buildScene/arena", buildScene<true>);
+
+	//instantiates a prototype with 8 string properties and 4 children and changes one property of the instance
+	void copyPrototype(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<std::string> s_stringPDs[8] = { {""}, {""}, {""}, {""}, {""}, {""}, {""}, {""} };
+		ps::PropertyContainer root;
+		auto& prototype = root.addChildContainer<ps::PropertyContainer>();
+		for (auto& pd : s_stringPDs)
+			prototype.setProperty(pd, std::string(32, 'x'));
+		for (size_t child = 0; child < 4; ++child)
+		{
+			auto& container = prototype.addChildContainer<ps::PropertyContainer>();
+			container.setProperty(StringPD, std::string(32, 'y'));
+			container.setProperty(IntPD, 1);
+		}
+		state.measure([&](size_t i) {
+			ps::PropertyContainer instance(prototype);
+			instance.changeProperty(s_stringPDs[0], std::string(i & 1 ? "a" : "b"));
+			bench::doNotOptimize(instance.getProperty(s_stringPDs[0]));
+		});
+	}
+	BENCHMARK("PropertyContainer::copy/prototype", copyPrototype);
+
+	//loads a snapshot of 1024 containers with 4 properties each
+	void loadSnapshot(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<int> s_levelPD(0, "bench.level");
+		static const ps::PropertyDescriptor<float> s_scalePD(0.f, "bench.scale");
+		static const ps::PropertyDescriptor<std::string> s_namePD("", "bench.name");
+		static const ps::PropertyDescriptor<std::vector<float>> s_weightsPD(std::vector<float>{}, "bench.weights");
+		ps::SnapshotSchema<> schema;
+		schema.add(s_levelPD);
+		schema.add(s_scalePD);
+		schema.add(s_namePD);
+		schema.add(s_weightsPD);
+		ps::PropertyContainer source;
+		for (int i = 0; i < 1024; ++i)
+		{
+			auto& child = source.addChildContainer<ps::PropertyContainer>();
+			child.setProperty(s_levelPD, i);
+			child.setProperty(s_scalePD, 1.f);
+			child.setProperty(s_namePD, "child");
+			child.setProperty(s_weightsPD, std::vector<float>(4, 1.f));
+		}
+		std::vector<char> snapshot;
+		schema.save(source, snapshot);
+		state.measure([&](size_t) {
+			ps::PropertyContainer root;
+			schema.load(snapshot.data(), snapshot.size(), root);
+			bench::doNotOptimize(root.size());
+		});
+	}
+	BENCHMARK("SnapshotSchema::load/containers:1024", loadSnapshot);
+
+	//mirrors 64 changes of a hierarchy with 1024 containers into a replica, the alternative to a full snapshot (see above)
+	void mirrorDelta(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<int> s_levelPD(0, "bench.journal.level");
+		ps::SnapshotSchema<> schema;
+		schema.add(s_levelPD);
+		ps::PropertyContainer source, replica;
+		for (int i = 0; i < 1024; ++i)
+		{
+			source.addChildContainer<ps::PropertyContainer>().setProperty(s_levelPD, 0);
+			replica.addChildContainer<ps::PropertyContainer>().setProperty(s_levelPD, 0);
+		}
+		std::vector<ps::PropertyContainer*> children;
+		for (auto it = source.cbegin(); it != source.cend(); ++it)
+			children.push_back(static_cast<ps::PropertyContainer*>(it->get()));
+		source.emit();
+		replica.emit();
+		ps::ChangeJournal<> journal(source, schema);
+		std::vector<char> delta;
+		state.measure([&](size_t iteration) {
+			for (size_t i = 0; i < 64; ++i)
+				children[(iteration * 64 + i * 17) % children.size()]->setProperty(s_levelPD, static_cast<int>(iteration));
+			source.emit();
+			delta.clear();
+			journal.takeDelta(delta);
+			ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica);
+			replica.emit();
+		});
+	}
+	BENCHMARK("ChangeJournal::applyDelta/containers:1024/changes:64", mirrorDelta);
+
+#ifndef _WIN32
+	//the read of a reader process, compare with the round trip of a socket based polling
+	void sharedPropertyRead(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<double> s_loadPD(0., "bench.shared.load");
+		ps::PropertyContainer root;
+		const std::string segmentName = "/cppproperties_bench_" + std::to_string(::getpid());
+		ps::SharedPropertyPublisher<> publisher(segmentName, root);
+		publisher.add(s_loadPD);
+		publisher.publish();
+		ps::SharedPropertyReader reader(segmentName);
+		auto load = reader.find<double>("bench.shared.load");
+		state.measure([&](size_t) {
+			bench::doNotOptimize(load.read());
+		});
+	}
+	BENCHMARK("SharedPropertyView::read", sharedPropertyRead);
+
+	//setProperty + emit of a published property, the publisher writes the slot during the emit
+	template<bool IsPublished>
+	void sharedPropertyEmit(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<double> s_loadPD(0., "bench.shared.emitLoad");
+		ps::PropertyContainer root;
+		const std::string segmentName = "/cppproperties_bench_emit_" + std::to_string(::getpid());
+		ps::SharedPropertyPublisher<> publisher(segmentName, root);
+		if (IsPublished)
+		{
+			publisher.add(s_loadPD);
+			publisher.publish();
+		}
+		else
+			root.connect(s_loadPD, [](double value) { bench::doNotOptimize(value); });
+		state.measure([&](size_t iteration) {
+			root.setProperty(s_loadPD, static_cast<double>(iteration));
+			root.emit();
+		});
+	}
+	BENCHMARK("PropertyContainer::emit/connected", sharedPropertyEmit<false>);
+	BENCHMARK("PropertyContainer::emit/published", sharedPropertyEmit<true>);
+#endif
+
+	//the read of a thread that observes a container, while the owning thread keeps setting and emitting the value
+	template<typename T>
+	void concurrentRead(bench::State& state, const ps::PropertyDescriptor<T>& pd, T(*makeValue)(size_t))
+	{
+		ps::PropertyContainer root;
+		root.setProperty(pd, makeValue(0));
+		ps::ConcurrentReads<> reads(root);
+		auto view = reads.add(pd);
+		std::atomic<bool> isDone = false;
+		std::thread writer([&]() {
+			for (size_t i = 1; !isDone.load(std::memory_order_relaxed); ++i)
+			{
+				root.setProperty(pd, makeValue(i));
+				root.emit();
+			}
+		});
+		state.measure([&](size_t) {
+			bench::doNotOptimize(view.visit([](const T& value) { return sizeof(value); }));
+		});
+		isDone = true;
+		writer.join();
+	}
+	void concurrentReadSeqlock(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<std::array<double, 4>> s_transformPD(std::array<double, 4>{});
+		concurrentRead<std::array<double, 4>>(state, s_transformPD, [](size_t i) { return std::array<double, 4>{ double(i), double(i), double(i), double(i) }; });
+	}
+	BENCHMARK("ConcurrentPropertyView::read/seqlock", concurrentReadSeqlock);
+	void concurrentReadEpoch(bench::State& state)
+	{
+		static const ps::PropertyDescriptor<std::string> s_titlePD(std::string{});
+		concurrentRead<std::string>(state, s_titlePD, [](size_t i) { return "a title that doesn't fit the small buffer " + std::to_string(i); });
+	}
+	BENCHMARK("ConcurrentPropertyView::read/epoch", concurrentReadEpoch);
+
+	//looks up the names of 256 PDs, like a config loader that calls setPropertyByName for every entry
+	template<bool IsFrozen>
+	void registryFind(bench::State& state)
+	{
+		static const auto s_pds = [] {
+			std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> pds;
+			for (size_t i = 0; i < s_configSize; ++i)
+				pds.push_back(std::make_unique<ps::PropertyDescriptor<int>>(0, "bench.config.entry" + std::to_string(i)));
+			return pds;
+		}();
+		ps::PropertyDescriptorRegistry registry;
+		for (const auto& pd : s_pds)
+			registry.add(pd->getName(), *pd);
+		if (IsFrozen)
+			registry.freeze();
+		std::vector<std::string> names;
+		for (const auto& pd : s_pds)
+			names.push_back(pd->getName());
+		state.measure([&](size_t) {
+			for (const auto& name : names)
+				bench::doNotOptimize(registry.find(name));
+		});
+	}
+	BENCHMARK("PropertyDescriptorRegistry::find/names:256", registryFind<false>);
+	BENCHMARK("PropertyDescriptorRegistry::find/frozen/names:256", registryFind<true>);
+
+	//replays 65536 records for 16 PDs on 64 containers (ns/op is per record)
+	void ingestRecords(bench::State& state)
+	{
+		static const auto s_pds = [] {
+			std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> pds;
+			for (size_t i = 0; i < 16; ++i)
+				pds.push_back(std::make_unique<ps::PropertyDescriptor<int>>(0, "bench.ingest.value" + std::to_string(i)));
+			return pds;
+		}();
+		constexpr size_t recordCount = 1 << 16;
+		ps::PropertyContainer root;
+		for (int i = 0; i < 64; ++i)
+			root.addChildContainer<ps::PropertyContainer>();
+		std::vector<std::string> records;
+		for (size_t i = 0; i < recordCount; ++i)
+			records.push_back("/" + std::to_string(i % 64) + " " + s_pds[i % 16]->getName() + " " + std::to_string(i) + "\n");
+		ps::PropertyIngestor ingestor(root);
+		state.measureBatches(recordCount, [] { return 0; }, [&](int, size_t i) {
+			ingestor.feed(records[i].data(), records[i].size());
+			if (i + 1 == recordCount)
+				ingestor.finish();
+		});
+	}
+	BENCHMARK("PropertyIngestor::feed/records:65536", ingestRecords);
+
+	//###########################################################################
+	//#
+	//#                        ProxyProperty
+	//#
+	//############################################################################
+
+	void proxyRecompute(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 0);
+		root.setProperty(OtherIntPD, 1);
+		root.setProperty(FloatPD, 2.f);
+		auto& child = root.addChildContainer<ps::PropertyContainer>();
+		auto sumLambda = [](int a, int b, float c) { return a + b + static_cast<int>(c); };
+		child.setProperty(SumPD, ps::make_proxy_property(sumLambda, IntPD, OtherIntPD, FloatPD));
+		int sink = 0;
+		child.connect(SumPD, [&sink](int value) { sink += value; });
+		state.measure([&](size_t i) {
+			root.changeProperty(IntPD, static_cast<int>(i + 1));
+			root.emit();
+		});
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("make_proxy_property/recompute", proxyRecompute);
+
+	//a proxy property over 8 inputs that all change within one frame
+	ps::PropertyDescriptor<int> InputPDs[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	template<bool IsLazy, size_t... Is>
+	void proxyManyInputs(bench::State& state, std::index_sequence<Is...>)
+	{
+		ps::PropertyContainer root;
+		(root.setProperty(InputPDs[Is], 0), ...);
+		auto& child = root.addChildContainer<ps::PropertyContainer>();
+		auto sumLambda = [](auto... values) { return (values + ...); };
+		if constexpr (IsLazy)
+			child.setProperty(SumPD, ps::make_lazy_proxy_property(sumLambda, InputPDs[Is]...));
+		else
+			child.setProperty(SumPD, ps::make_proxy_property(sumLambda, InputPDs[Is]...));
+		int sink = 0;
+		child.connect(SumPD, [&sink](int value) { sink += value; });
+		state.measure([&](size_t i) {
+			(root.changeProperty(InputPDs[Is], static_cast<int>(i + Is)), ...);
+			root.emit();
+		});
+		bench::doNotOptimize(sink);
+	}
+	void proxyManyInputsEager(bench::State& state) { proxyManyInputs<false>(state, std::make_index_sequence<8>{}); }
+	void proxyManyInputsLazy(bench::State& state) { proxyManyInputs<true>(state, std::make_index_sequence<8>{}); }
+	BENCHMARK("make_proxy_property/8inputs", proxyManyInputsEager);
+	BENCHMARK("make_lazy_proxy_property/8inputs", proxyManyInputsLazy);
+
+	//an expensive pure function whose input toggles between two values
+	template<bool IsMemoized>
+	void proxyToggle(bench::State& state)
+	{
+		ps::PropertyContainer root;
+		root.setProperty(IntPD, 0);
+		auto& child = root.addChildContainer<ps::PropertyContainer>();
+		auto expensiveLambda = [](int input) {
+			std::string result;
+			for (int i = 0; i < 64; ++i)
+				result += std::to_string(input * i);
+			return result;
+		};
+		if constexpr (IsMemoized)
+			child.setProperty(StringPD, ps::make_memoized_proxy_property(4, expensiveLambda, IntPD));
+		else
+			child.setProperty(StringPD, ps::make_proxy_property(expensiveLambda, IntPD));
+		size_t sink = 0;
+		child.connect(StringPD, [&sink](const std::string& value) { sink += value.size(); });
+		state.measure([&](size_t i) {
+			root.changeProperty(IntPD, static_cast<int>(i & 1));
+			root.emit();
+		});
+		bench::doNotOptimize(sink);
+	}
+	BENCHMARK("make_proxy_property/toggle", proxyToggle<false>);
+	BENCHMARK("make_memoized_proxy_property/toggle", proxyToggle<true>);
+}
+
+//usage: CppProperties_bench [--quick] [--filter=<substring>] [--min-time=<seconds>] [--out=<file>]
+int main(int argc, char** argv)
+{
+	double minTimeSeconds = 0.2;
+	std::string filter;
+	std::string outFile;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string arg = argv[i];
+		if (arg == "--quick")
+			minTimeSeconds = 0.001;
+		else if (arg.rfind("--filter=", 0) == 0)
+			filter = arg.substr(std::strlen("--filter="));
+		else if (arg.rfind("--min-time=", 0) == 0)
+			minTimeSeconds = std::stod(arg.substr(std::strlen("--min-time=")));
+		else if (arg.rfind("--out=", 0) == 0)
+			outFile = arg.substr(std::strlen("--out="));
+		else
+		{
+			std::cerr << "unknown argument: " << arg << "\n"
+				<< "usage: " << argv[0] << " [--quick] [--filter=<substring>] [--min-time=<seconds>] [--out=<file>]\n";
+			return 1;
+		}
+	}
+
+	const auto minTime = std::chrono::duration_cast<bench::State::Clock::duration>(std::chrono::duration<double>(minTimeSeconds));
+	std::vector<bench::Result> results;
+	for (const auto& benchmark : bench::registry())
+	{
+		if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+			continue;
+		bench::State state(benchmark.name, minTime);
+		benchmark.func(state);
+		results.push_back(state.getResult());
+		std::cerr << benchmark.name << ": " << state.getResult().nsPerOp() << " ns/op\n";
+	}
+
+	if (outFile.empty())
+	{
+		bench::writeJson(std::cout, results, CPPPROPERTIES_VERSION);
+		return 0;
+	}
+	std::ofstream out(outFile);
+	if (!out)
+	{
+		std::cerr << "could not open " << outFile << "\n";
+		return 1;
+	}
+	bench::writeJson(out, results, CPPPROPERTIES_VERSION);
+	return 0;
+}
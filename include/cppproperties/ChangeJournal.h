@@ -0,0 +1,469 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        ChangeJournal
+	//#
+	//############################################################################
+
+	//records all the changes of a hierarchy and serializes them as a compact binary delta,
+	//applyDelta applies the delta to a replica of the hierarchy (e.g. in another process)
+	//a changed property is recorded when it's emitted (with the value it has then), a removed property, a property
+	//that was set without changing its value and an added, removed or moved child container right away
+	//only the PDs of the schema are recorded, the values are encoded with its codecs
+	//the replica has to have the same structure as the hierarchy when the journal is created (e.g. loaded from a snapshot of it),
+	//it has to get all the deltas in order and applyDelta has to use a schema with the same PDs in the same order
+	//containers are identified by their path from the root: the index of the child at every level (see getChildContainer)
+	//layout: header, then the records: [record kind][record], the records are
+	//	changes: [path][entry count][entries: descriptor index, size, value]
+	//	the descriptor index of a removed property has the s_removedFlag set and is followed by no value
+	//	child added: [path of the parent][the child and its subtree in the format of a snapshot (see SnapshotSchema)]
+	//	child removed: [path of the child]
+	//	child moved: [path of the child][path of the new parent], both from before the child is moved
+	//a path is [path length][index of the child at every level]
+	template<typename ContainerT = PropertyContainer>
+	class ChangeJournal : public ContainerT::ChangeListener
+	{
+		using ContainerBaseT = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const ContainerT&>().getParent())>>;
+		using SchemaT = SnapshotSchema<ContainerT>;
+		static constexpr char s_magic[4] = { 'C', 'P', 'P', 'D' };
+		static constexpr uint32_t s_version = 2;
+		static constexpr uint32_t s_removedFlag = 0x80000000u;
+
+		enum class RecordKind : uint32_t { Changes, ChildAdded, ChildRemoved, ChildMoved };
+
+		ContainerT& m_root;
+		const SchemaT& m_schema;
+		std::vector<char> m_records;
+		uint32_t m_recordCount = 0;
+		//consecutive changes of the same container share the path
+		const ContainerBaseT* m_lastContainer = nullptr;
+		size_t m_entryCountOffset = 0;
+		//the paths only have to be computed again if the hierarchy was restructured, see PropertyContainer::getStructureGeneration
+		std::unordered_map<const ContainerBaseT*, std::vector<uint32_t>> m_paths;
+		uint64_t m_pathsGeneration = 0;
+		//independent subtrees might be emitted in parallel
+		mutable std::mutex m_mutex;
+
+	public:
+		//the journal records the changes of the root until it's destroyed, the root and the schema have to outlive it
+		ChangeJournal(ContainerT& root, const SchemaT& schema)
+			: m_root(root)
+			, m_schema(schema)
+		{
+			assert(!m_root.getParent() && "the journal has to be set at the root of the hierarchy");
+			//creates the generation counter of the hierarchy before the changes are reported from several threads
+			m_pathsGeneration = m_root.getStructureGeneration();
+			m_root.setChangeListener(this);
+		}
+		ChangeJournal(const ChangeJournal&) = delete;
+		ChangeJournal& operator=(const ChangeJournal&) = delete;
+		~ChangeJournal()
+		{
+			if (m_root.getChangeListener() == this)
+				m_root.setChangeListener(nullptr);
+		}
+
+		void onPropertyChanged(const ContainerBaseT& container, const PropertyDescriptorBase& pd, const void* value) override
+		{
+			const auto* entry = m_schema.findEntry(pd);
+			if (!entry)
+				return;
+			std::lock_guard lock(m_mutex);
+			beginEntryInternal(container);
+			SchemaT::writeUInt(m_records, static_cast<uint32_t>(entry - m_schema.m_entries.data()));
+			const size_t sizeOffset = m_records.size();
+			SchemaT::writeUInt(m_records, 0);
+			entry->m_encode(value, m_records);
+			SchemaT::patchUInt(m_records, sizeOffset, static_cast<uint32_t>(m_records.size() - sizeOffset - sizeof(uint32_t)));
+		}
+
+		void onPropertyRemoved(const ContainerBaseT& container, const PropertyDescriptorBase& pd) override
+		{
+			const auto* entry = m_schema.findEntry(pd);
+			if (!entry)
+				return;
+			std::lock_guard lock(m_mutex);
+			beginEntryInternal(container);
+			SchemaT::writeUInt(m_records, static_cast<uint32_t>(entry - m_schema.m_entries.data()) | s_removedFlag);
+		}
+
+		void onChildAdded(const ContainerBaseT& parent, const ContainerBaseT& child) override
+		{
+			std::lock_guard lock(m_mutex);
+			beginRecordInternal(RecordKind::ChildAdded);
+			writePathInternal(parent);
+			m_schema.saveContainer(child, m_records);
+		}
+
+		void onChildRemoved(const ContainerBaseT&, const ContainerBaseT& child) override
+		{
+			std::lock_guard lock(m_mutex);
+			beginRecordInternal(RecordKind::ChildRemoved);
+			writePathInternal(child);
+		}
+
+		void onChildMoved(const ContainerBaseT& child, const ContainerBaseT& newParent) override
+		{
+			std::lock_guard lock(m_mutex);
+			beginRecordInternal(RecordKind::ChildMoved);
+			writePathInternal(child);
+			writePathInternal(newParent);
+		}
+
+		//true if no change was recorded since the last delta was taken
+		[[nodiscard]] bool empty() const
+		{
+			std::lock_guard lock(m_mutex);
+			return m_recordCount == 0;
+		}
+
+		//appends the delta of all the changes since the last call to out and starts a new delta
+		//call it after emit, changes that weren't emitted yet are part of the next delta
+		void takeDelta(std::vector<char>& out)
+		{
+			std::lock_guard lock(m_mutex);
+			out.insert(out.end(), std::begin(s_magic), std::end(s_magic));
+			SchemaT::writeUInt(out, s_version);
+			SchemaT::writeUInt(out, static_cast<uint32_t>(m_schema.m_entries.size()));
+			SchemaT::writeUInt(out, m_recordCount);
+			out.insert(out.end(), m_records.begin(), m_records.end());
+			m_records.clear();
+			m_recordCount = 0;
+			m_lastContainer = nullptr;
+		}
+
+		//applies a delta to the replica, the changes are signaled with the next emit of the replica
+		//throws std::runtime_error if the delta is malformed or doesn't match the replica, the whole delta is checked
+		//against the structure of the replica first, so the replica is left untouched then
+		//(only a value that the codec of the schema can't decode throws while the delta is applied)
+		static void applyDelta(const SchemaT& schema, const char* data, size_t size, ContainerT& replicaRoot)
+		{
+			validateDeltaInternal(schema, data, size, replicaRoot);
+			typename SchemaT::Reader reader(data, size);
+			const uint32_t recordCount = readHeaderInternal(reader, schema);
+			std::vector<const typename SchemaT::Entry*> entries;
+			for (uint32_t i = 0; i < recordCount; ++i)
+			{
+				ContainerBaseT* parent = nullptr;
+				switch (static_cast<RecordKind>(reader.readUInt()))
+				{
+				case RecordKind::Changes:
+				{
+					//the children of the replica are ContainerT, like the children that are loaded from a snapshot
+					auto& container = static_cast<ContainerT&>(findContainerInternal(reader, replicaRoot));
+					const uint32_t entryCount = reader.readUInt();
+					for (uint32_t j = 0; j < entryCount; ++j)
+					{
+						const uint32_t descriptorIndex = reader.readUInt();
+						const auto& entry = schema.m_entries[descriptorIndex & ~s_removedFlag];
+						if (descriptorIndex & s_removedFlag)
+						{
+							entry.m_remove(container, *entry.m_pd);
+							continue;
+						}
+						const uint32_t valueSize = reader.readUInt();
+						entry.m_load(container, *entry.m_pd, reader.read(valueSize), valueSize);
+					}
+					break;
+				}
+				case RecordKind::ChildAdded:
+				{
+					auto& container = findContainerInternal(reader, replicaRoot);
+					if (entries.empty())
+					{
+						for (const auto& entry : schema.m_entries)
+							entries.push_back(&entry);
+					}
+					auto loaded = schema.readHierarchy(reader, entries);
+					container.addChildContainer(SchemaT::takeHierarchy(loaded));
+					break;
+				}
+				case RecordKind::ChildRemoved:
+				{
+					auto& child = findContainerInternal(reader, replicaRoot, &parent);
+					parent->removeChild(child);
+					break;
+				}
+				case RecordKind::ChildMoved:
+				{
+					auto& child = findContainerInternal(reader, replicaRoot, &parent);
+					parent->reparent(child, findContainerInternal(reader, replicaRoot));
+					break;
+				}
+				}
+			}
+		}
+
+	private:
+		void beginRecordInternal(RecordKind kind)
+		{
+			++m_recordCount;
+			//the changes that are recorded afterwards start a new record
+			m_lastContainer = nullptr;
+			SchemaT::writeUInt(m_records, static_cast<uint32_t>(kind));
+		}
+
+		void writePathInternal(const ContainerBaseT& container)
+		{
+			const auto& path = getPathInternal(container);
+			SchemaT::writeUInt(m_records, static_cast<uint32_t>(path.size()));
+			for (const uint32_t index : path)
+				SchemaT::writeUInt(m_records, index);
+		}
+
+		void beginEntryInternal(const ContainerBaseT& container)
+		{
+			//a container that was destroyed since might have the same address
+			if (m_lastContainer != &container || m_root.getStructureGeneration() != m_pathsGeneration)
+			{
+				beginRecordInternal(RecordKind::Changes);
+				m_lastContainer = &container;
+				writePathInternal(container);
+				m_entryCountOffset = m_records.size();
+				SchemaT::writeUInt(m_records, 0);
+			}
+			uint32_t entryCount;
+			std::memcpy(&entryCount, m_records.data() + m_entryCountOffset, sizeof(entryCount));
+			SchemaT::patchUInt(m_records, m_entryCountOffset, entryCount + 1);
+		}
+
+		const std::vector<uint32_t>& getPathInternal(const ContainerBaseT& container)
+		{
+			if (const uint64_t generation = m_root.getStructureGeneration(); generation != m_pathsGeneration)
+			{
+				m_paths.clear();
+				m_pathsGeneration = generation;
+			}
+			auto [it, isNew] = m_paths.try_emplace(&container);
+			auto& path = it->second;
+			if (!isNew)
+				return path;
+			for (const auto* child = &container; child->getParent(); child = child->getParent())
+				path.push_back(static_cast<uint32_t>(child->getChildIndex()));
+			std::reverse(path.begin(), path.end());
+			return path;
+		}
+
+		static uint32_t readHeaderInternal(typename SchemaT::Reader& reader, const SchemaT& schema)
+		{
+			if (std::memcmp(reader.read(sizeof(s_magic)), s_magic, sizeof(s_magic)) != 0)
+				throw std::runtime_error("ChangeJournal: the data isn't a delta");
+			if (reader.readUInt() != s_version)
+				throw std::runtime_error("ChangeJournal: unsupported delta version");
+			if (reader.readUInt() != schema.m_entries.size())
+				throw std::runtime_error("ChangeJournal: the delta was recorded with a different schema");
+			return reader.readUInt();
+		}
+
+		static ContainerBaseT& findContainerInternal(typename SchemaT::Reader& reader, ContainerBaseT& root, ContainerBaseT** parent = nullptr)
+		{
+			ContainerBaseT* container = &root;
+			const uint32_t pathLength = reader.readUInt();
+			for (uint32_t i = 0; i < pathLength; ++i)
+			{
+				if (parent)
+					*parent = container;
+				container = container->getChildContainer(reader.readUInt());
+				if (!container)
+					throw std::runtime_error("ChangeJournal: the replica doesn't have the container of the delta");
+			}
+			return *container;
+		}
+
+		//the structure of the replica while a delta is validated, the nodes are only created for the containers the delta refers to
+		struct ShadowNode
+		{
+			//nullptr for the containers that are added by the delta
+			const ContainerBaseT* m_container = nullptr;
+			//false as long as the children are the ones of the container
+			bool m_hasOwnChildren = false;
+			std::vector<ShadowNode*> m_children;
+		};
+
+		class ShadowHierarchy
+		{
+			std::deque<ShadowNode> m_nodes;
+			std::unordered_map<const ContainerBaseT*, ShadowNode*> m_nodeByContainer;
+			ShadowNode* m_root;
+		public:
+			explicit ShadowHierarchy(const ContainerBaseT& root)
+				: m_root(&getNode(root)) {}
+
+			ShadowNode& getRoot() noexcept
+			{
+				return *m_root;
+			}
+			ShadowNode& getNode(const ContainerBaseT& container)
+			{
+				auto& node = m_nodeByContainer[&container];
+				if (!node)
+				{
+					node = &m_nodes.emplace_back();
+					node->m_container = &container;
+				}
+				return *node;
+			}
+			ShadowNode& addNode()
+			{
+				auto& node = m_nodes.emplace_back();
+				node.m_hasOwnChildren = true;
+				return node;
+			}
+			ShadowNode* getChild(ShadowNode& node, uint32_t index)
+			{
+				if (node.m_hasOwnChildren)
+					return index < node.m_children.size() ? node.m_children[index] : nullptr;
+				auto* child = node.m_container->getChildContainer(index);
+				return child ? &getNode(*child) : nullptr;
+			}
+			//the children of the node, they are copied from the container before they are changed
+			std::vector<ShadowNode*>& getChildren(ShadowNode& node)
+			{
+				if (!node.m_hasOwnChildren)
+				{
+					node.m_hasOwnChildren = true;
+					for (auto it = node.m_container->cbegin(); it != node.m_container->cend(); ++it)
+					{
+						if (!(*it)->isProxyProperty())
+							node.m_children.push_back(&getNode(**it));
+					}
+				}
+				return node.m_children;
+			}
+		};
+
+		//path holds the nodes from the root to the container
+		static void resolvePathInternal(typename SchemaT::Reader& reader, ShadowHierarchy& shadow, std::vector<ShadowNode*>& path, std::vector<uint32_t>& indices)
+		{
+			path.assign(1, &shadow.getRoot());
+			indices.clear();
+			const uint32_t pathLength = reader.readUInt();
+			for (uint32_t i = 0; i < pathLength; ++i)
+			{
+				indices.push_back(reader.readUInt());
+				path.push_back(shadow.getChild(*path.back(), indices.back()));
+				if (!path.back())
+					throw std::runtime_error("ChangeJournal: the replica doesn't have the container of the delta");
+			}
+		}
+
+		//removes the child like PropertyContainer::removeChild, the last child takes over its position
+		static ShadowNode& removeChildInternal(ShadowHierarchy& shadow, const std::vector<ShadowNode*>& path, const std::vector<uint32_t>& indices)
+		{
+			if (indices.empty())
+				throw std::runtime_error("ChangeJournal: the root of the replica can't be removed or moved");
+			auto& siblings = shadow.getChildren(*path[path.size() - 2]);
+			auto& child = *siblings[indices.back()];
+			siblings[indices.back()] = siblings.back();
+			siblings.pop_back();
+			return child;
+		}
+
+		static void skipPropertiesInternal(typename SchemaT::Reader& reader, const SchemaT& schema)
+		{
+			const uint32_t propertyCount = reader.readUInt();
+			for (uint32_t i = 0; i < propertyCount; ++i)
+			{
+				if (reader.readUInt() >= schema.m_entries.size())
+					throw std::runtime_error("ChangeJournal: invalid descriptor index");
+				reader.read(reader.readUInt());
+			}
+		}
+
+		//reads the whole delta without changing the replica, throws if it's malformed or doesn't match the replica
+		static void validateDeltaInternal(const SchemaT& schema, const char* data, size_t size, const ContainerT& replicaRoot)
+		{
+			typename SchemaT::Reader reader(data, size);
+			const uint32_t recordCount = readHeaderInternal(reader, schema);
+			ShadowHierarchy shadow(replicaRoot);
+			std::vector<ShadowNode*> path, newParentPath;
+			std::vector<uint32_t> indices, newParentIndices;
+			//the added subtree: the node and the number of children that are still to be read
+			std::vector<std::pair<ShadowNode*, uint32_t>> stack;
+			for (uint32_t i = 0; i < recordCount; ++i)
+			{
+				switch (static_cast<RecordKind>(reader.readUInt()))
+				{
+				case RecordKind::Changes:
+				{
+					resolvePathInternal(reader, shadow, path, indices);
+					const uint32_t entryCount = reader.readUInt();
+					for (uint32_t j = 0; j < entryCount; ++j)
+					{
+						const uint32_t descriptorIndex = reader.readUInt();
+						if ((descriptorIndex & ~s_removedFlag) >= schema.m_entries.size())
+							throw std::runtime_error("ChangeJournal: invalid descriptor index");
+						if (!(descriptorIndex & s_removedFlag))
+							reader.read(reader.readUInt());
+					}
+					break;
+				}
+				case RecordKind::ChildAdded:
+				{
+					resolvePathInternal(reader, shadow, path, indices);
+					auto& child = shadow.addNode();
+					skipPropertiesInternal(reader, schema);
+					stack.assign(1, { &child, reader.readUInt() });
+					while (!stack.empty())
+					{
+						if (stack.back().second == 0)
+						{
+							stack.pop_back();
+							continue;
+						}
+						--stack.back().second;
+						if (stack.size() > schema.m_maxDepth)
+							throw std::runtime_error("ChangeJournal: the added container is nested too deeply");
+						auto& grandChild = shadow.addNode();
+						stack.back().first->m_children.push_back(&grandChild);
+						skipPropertiesInternal(reader, schema);
+						const uint32_t childCount = reader.readUInt();
+						stack.push_back({ &grandChild, childCount });
+					}
+					shadow.getChildren(*path.back()).push_back(&child);
+					break;
+				}
+				case RecordKind::ChildRemoved:
+				{
+					resolvePathInternal(reader, shadow, path, indices);
+					removeChildInternal(shadow, path, indices);
+					break;
+				}
+				case RecordKind::ChildMoved:
+				{
+					resolvePathInternal(reader, shadow, path, indices);
+					resolvePathInternal(reader, shadow, newParentPath, newParentIndices);
+					if (std::find(newParentPath.begin(), newParentPath.end(), path.back()) != newParentPath.end())
+						throw std::runtime_error("ChangeJournal: a container can't be moved into its own subtree");
+					auto& child = removeChildInternal(shadow, path, indices);
+					shadow.getChildren(*newParentPath.back()).push_back(&child);
+					break;
+				}
+				default:
+					throw std::runtime_error("ChangeJournal: invalid record kind");
+				}
+			}
+			if (!reader.atEnd())
+				throw std::runtime_error("ChangeJournal: unexpected data at the end of the delta");
+		}
+	};
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
+namespace ps
+{
+	template<typename U, typename T, typename = void>
+	struct is_inequality_comparable : std::false_type {};
+	template<typename U, typename T>
+	struct is_inequality_comparable<U, T, std::void_t<decltype(std::declval<const U&>() != std::declval<const T&>())>> : std::true_type {};
+	template<typename U, typename T>
+	inline constexpr bool is_inequality_comparable_v = is_inequality_comparable<U, T>::value;
+
+	//###########################################################################
+	//#
+	//#                        ChangePolicy
+	//#
+	//############################################################################
+
+	//a change policy decides if setting a new value changes a property and has to be signaled
+	//without a change policy a property compares the values with operator != (values without one are always a change)
+	//the policy is usually given to the PropertyDescriptor, all properties of that PD use it then
+	//(the PD owns the policy, properties only refer to it)
+	//e.g. PropertyDescriptor<float> OpacityPD(1.f, ps::EpsilonChangePolicy<float>(0.001f));
+	template<typename T>
+	class ChangePolicy
+	{
+	public:
+		virtual ~ChangePolicy() = default;
+		virtual bool hasChanged(const T& currentValue, const T& newValue) const = 0;
+	};
+
+	//every set is a change, nothing is compared
+	//useful for large values where the comparison costs more than the update (meshes, buffers)
+	template<typename T>
+	class AlwaysChangedPolicy : public ChangePolicy<T>
+	{
+	public:
+		bool hasChanged(const T&, const T&) const override
+		{
+			return true;
+		}
+	};
+
+	//floating point values only change if they differ by more than epsilon
+	//a NaN only changes to / from a value that isn't NaN
+	template<typename T>
+	class EpsilonChangePolicy : public ChangePolicy<T>
+	{
+		static_assert(std::is_floating_point_v<T>, "The EpsilonChangePolicy can only be used for floating point types.");
+		T m_epsilon;
+	public:
+		explicit EpsilonChangePolicy(T epsilon) noexcept
+			: m_epsilon(epsilon) {}
+
+		bool hasChanged(const T& currentValue, const T& newValue) const override
+		{
+			if (std::isnan(currentValue) || std::isnan(newValue))
+				return std::isnan(currentValue) != std::isnan(newValue);
+			return std::abs(currentValue - newValue) > m_epsilon;
+		}
+	};
+
+	//compares a cheap key of the values instead of the values, e.g. a version counter or a cached hash
+	//PropertyDescriptor<Mesh> MeshPD(Mesh{}, ps::make_projection_change_policy<Mesh>([](const Mesh& mesh) { return mesh.getVersion(); }));
+	template<typename T, typename FuncT>
+	class ProjectionChangePolicy : public ChangePolicy<T>
+	{
+		FuncT m_projection;
+	public:
+		explicit ProjectionChangePolicy(FuncT projection)
+			: m_projection(std::move(projection)) {}
+
+		bool hasChanged(const T& currentValue, const T& newValue) const override
+		{
+			return m_projection(currentValue) != m_projection(newValue);
+		}
+	};
+
+	template<typename T, typename FuncT>
+	ProjectionChangePolicy<T, std::decay_t<FuncT>> make_projection_change_policy(FuncT&& projection)
+	{
+		return ProjectionChangePolicy<T, std::decay_t<FuncT>>(std::forward<FuncT>(projection));
+	}
+}
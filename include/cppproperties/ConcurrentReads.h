@@ -0,0 +1,387 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        EpochDomain
+	//#
+	//############################################################################
+
+	//epoch based reclamation: a reader pins the current epoch while it uses a pointer it loaded (see EpochGuard),
+	//a writer that replaces the pointer retires the old object, which is deleted once no reader
+	//pinned an epoch that could still see it
+	//readers never wait for a writer, a writer never waits for a reader (it only defers the deletion)
+	class EpochDomain
+	{
+	public:
+		//the number of threads that can be pinned at the same time
+		static constexpr size_t s_maxReaderCount = 128;
+	private:
+		struct alignas(64) ReaderSlot
+		{
+			//0 if the reader isn't pinned
+			std::atomic<uint64_t> m_epoch{ 0 };
+			std::atomic<bool> m_isUsed{ false };
+		};
+		struct Retired
+		{
+			void* m_ptr;
+			void(*m_delete)(void*);
+			uint64_t m_epoch;
+		};
+		struct ThreadRecord
+		{
+			EpochDomain* m_domain = nullptr;
+			ReaderSlot* m_slot = nullptr;
+			uint32_t m_pinDepth = 0;
+			~ThreadRecord()
+			{
+				if (m_slot)
+					m_slot->m_isUsed.store(false, std::memory_order_release);
+			}
+		};
+
+		std::atomic<uint64_t> m_epoch{ 1 };
+		std::array<ReaderSlot, s_maxReaderCount> m_readers;
+		std::mutex m_retiredMutex;
+		std::vector<Retired> m_retired;
+
+		EpochDomain() = default;
+
+		static ThreadRecord& threadRecord() noexcept
+		{
+			thread_local ThreadRecord s_record;
+			return s_record;
+		}
+
+		ReaderSlot& acquireSlotInternal()
+		{
+			for (auto& slot : m_readers)
+			{
+				bool isUsed = false;
+				if (!slot.m_isUsed.load(std::memory_order_relaxed) && slot.m_isUsed.compare_exchange_strong(isUsed, true, std::memory_order_acquire))
+					return slot;
+			}
+			throw std::runtime_error("EpochDomain: too many reader threads");
+		}
+
+		//the smallest pinned epoch, objects retired before it can't be seen by any reader anymore
+		uint64_t minPinnedEpochInternal() const noexcept
+		{
+			uint64_t minEpoch = UINT64_MAX;
+			for (const auto& slot : m_readers)
+			{
+				const uint64_t epoch = slot.m_epoch.load(std::memory_order_seq_cst);
+				if (epoch && epoch < minEpoch)
+					minEpoch = epoch;
+			}
+			return minEpoch;
+		}
+
+	public:
+		EpochDomain(const EpochDomain&) = delete;
+		EpochDomain& operator=(const EpochDomain&) = delete;
+		~EpochDomain()
+		{
+			for (const auto& retired : m_retired)
+				retired.m_delete(retired.m_ptr);
+		}
+
+		static EpochDomain& global()
+		{
+			static EpochDomain s_domain;
+			return s_domain;
+		}
+
+		//pins are counted per thread, so they can be nested
+		void pin()
+		{
+			auto& record = threadRecord();
+			if (record.m_pinDepth++)
+				return;
+			if (!record.m_slot)
+			{
+				record.m_slot = &acquireSlotInternal();
+				record.m_domain = this;
+			}
+			assert(record.m_domain == this && "a thread can only read in one epoch domain");
+			//seq_cst, so a writer that retires an object after this store sees the pin
+			record.m_slot->m_epoch.store(m_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		}
+
+		void unpin() noexcept
+		{
+			auto& record = threadRecord();
+			assert(record.m_pinDepth && "unpin without pin");
+			if (--record.m_pinDepth == 0)
+				record.m_slot->m_epoch.store(0, std::memory_order_release);
+		}
+
+		//the object has to be unreachable for new readers already, it's deleted once all readers that might see it are done
+		template<typename T>
+		void retire(const T* ptr)
+		{
+			if (!ptr)
+				return;
+			std::lock_guard lock(m_retiredMutex);
+			//readers that pin from now on get the new epoch and can't see the object anymore
+			const uint64_t epoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+			m_retired.push_back({ const_cast<T*>(ptr), +[](void* object) { delete static_cast<T*>(object); }, epoch });
+			reclaimInternal();
+		}
+
+		//deletes the retired objects that no reader can see anymore, retire does this as well
+		void reclaim()
+		{
+			std::lock_guard lock(m_retiredMutex);
+			reclaimInternal();
+		}
+
+		[[nodiscard]] size_t getRetiredCount()
+		{
+			std::lock_guard lock(m_retiredMutex);
+			return m_retired.size();
+		}
+
+	private:
+		void reclaimInternal()
+		{
+			const uint64_t minEpoch = minPinnedEpochInternal();
+			auto keepIt = m_retired.begin();
+			for (auto it = m_retired.begin(); it != m_retired.end(); ++it)
+			{
+				if (it->m_epoch < minEpoch)
+					it->m_delete(it->m_ptr);
+				else
+					*keepIt++ = *it;
+			}
+			m_retired.erase(keepIt, m_retired.end());
+		}
+	};
+
+	//pins the epoch of the domain for the scope, the objects that are loaded within the scope stay alive
+	class EpochGuard
+	{
+		EpochDomain& m_domain;
+	public:
+		explicit EpochGuard(EpochDomain& domain = EpochDomain::global())
+			: m_domain(domain)
+		{
+			m_domain.pin();
+		}
+		EpochGuard(const EpochGuard&) = delete;
+		EpochGuard& operator=(const EpochGuard&) = delete;
+		~EpochGuard()
+		{
+			m_domain.unpin();
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#                        ConcurrentValue
+	//#
+	//############################################################################
+
+	//a value that is written by one thread and read by any number of threads without locks
+	//small trivially copyable values are protected by a seqlock (the value is copied word by word with relaxed atomics,
+	//a reader retries if the writer was writing at the same time), larger values are replaced by a new copy
+	//and the old one is deleted via the EpochDomain once no reader uses it anymore
+	template<typename T, typename = void>
+	class ConcurrentValue
+	{
+		std::atomic<const T*> m_value;
+	public:
+		explicit ConcurrentValue(const T& value)
+			: m_value(new T(value))
+		{
+		}
+		ConcurrentValue(const ConcurrentValue&) = delete;
+		ConcurrentValue& operator=(const ConcurrentValue&) = delete;
+		~ConcurrentValue()
+		{
+			//the last reference is gone, so there is no reader anymore
+			delete m_value.load(std::memory_order_relaxed);
+		}
+
+		void store(const T& value)
+		{
+			EpochDomain::global().retire(m_value.exchange(new T(value), std::memory_order_seq_cst));
+		}
+
+		//invokes func with a const reference to the value, the value stays alive until func returns
+		template<typename FuncT>
+		decltype(auto) visit(FuncT&& func) const
+		{
+			EpochGuard guard;
+			return std::forward<FuncT>(func)(*m_value.load(std::memory_order_seq_cst));
+		}
+
+		[[nodiscard]] T load() const
+		{
+			return visit([](const T& value) { return value; });
+		}
+	};
+
+	//the seqlock is used for trivially copyable values of up to 64 bytes
+	template<typename T>
+	class ConcurrentValue<T, std::enable_if_t<std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T> && sizeof(T) <= 64>>
+	{
+		static constexpr size_t s_wordCount = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+		std::atomic<uint32_t> m_sequence{ 0 };
+		std::atomic<uint64_t> m_words[s_wordCount];
+	public:
+		explicit ConcurrentValue(const T& value)
+		{
+			uint64_t words[s_wordCount] = {};
+			std::memcpy(words, &value, sizeof(T));
+			for (size_t i = 0; i < s_wordCount; ++i)
+				m_words[i].store(words[i], std::memory_order_relaxed);
+		}
+		ConcurrentValue(const ConcurrentValue&) = delete;
+		ConcurrentValue& operator=(const ConcurrentValue&) = delete;
+
+		//only one thread may store at a time
+		void store(const T& value) noexcept
+		{
+			uint64_t words[s_wordCount] = {};
+			std::memcpy(words, &value, sizeof(T));
+			const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+			m_sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			for (size_t i = 0; i < s_wordCount; ++i)
+				m_words[i].store(words[i], std::memory_order_relaxed);
+			m_sequence.store(sequence + 2, std::memory_order_release);
+		}
+
+		[[nodiscard]] T load() const noexcept
+		{
+			uint64_t words[s_wordCount];
+			while (true)
+			{
+				const uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+				if (sequence & 1)
+					continue;
+				for (size_t i = 0; i < s_wordCount; ++i)
+					words[i] = m_words[i].load(std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (m_sequence.load(std::memory_order_relaxed) == sequence)
+					break;
+			}
+			T value;
+			std::memcpy(&value, words, sizeof(T));
+			return value;
+		}
+
+		template<typename FuncT>
+		decltype(auto) visit(FuncT&& func) const
+		{
+			const T value = load();
+			return std::forward<FuncT>(func)(value);
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#                        ConcurrentReads
+	//#
+	//############################################################################
+
+	//reads the value of a property from any thread, see ConcurrentReads::add
+	//the view can be copied to other threads and stays valid after the ConcurrentReads are destroyed
+	//(it keeps the last value then)
+	template<typename T>
+	class ConcurrentPropertyView
+	{
+		std::shared_ptr<const ConcurrentValue<T>> m_value;
+	public:
+		ConcurrentPropertyView() = default;
+		explicit ConcurrentPropertyView(std::shared_ptr<const ConcurrentValue<T>> value) noexcept
+			: m_value(std::move(value)) {}
+
+		//returns a copy of the value
+		[[nodiscard]] T get() const
+		{
+			return m_value->load();
+		}
+
+		//invokes func with the value without copying it (only large values are used in place)
+		template<typename FuncT>
+		decltype(auto) visit(FuncT&& func) const
+		{
+			return m_value->visit(std::forward<FuncT>(func));
+		}
+
+		[[nodiscard]] explicit operator bool() const noexcept
+		{
+			return m_value != nullptr;
+		}
+	};
+
+	//opt in for reading properties of a container from other threads (e.g. analytics threads), while the
+	//owning thread keeps changing the hierarchy without locks or stopping it
+	//getProperty can't be used from another thread, since the lookup and the value can change at any time,
+	//instead the value of every added PD is mirrored into a ConcurrentValue whenever the container emits it
+	//(readers see the values of the last emit, a removed property reads as the default value)
+	//the readers never access the properties themselves, so removing properties or destroying proxy properties is safe
+	//	ps::ConcurrentReads<> reads(player);
+	//	auto health = reads.add(HealthPD);
+	//	//on any thread
+	//	int value = health.get();
+	//the ConcurrentReads have to be destroyed before the container and on the thread that emits the container
+	template<typename ContainerT = PropertyContainer>
+	class ConcurrentReads
+	{
+		struct Connection
+		{
+			const PropertyDescriptorBase* m_pd = nullptr;
+			size_t m_index = 0;
+			void(*m_disconnect)(ContainerT& container, const PropertyDescriptorBase& pd, size_t index) = nullptr;
+		};
+		ContainerT& m_container;
+		std::vector<Connection> m_connections;
+	public:
+		explicit ConcurrentReads(ContainerT& container) noexcept
+			: m_container(container)
+		{
+		}
+		ConcurrentReads(const ConcurrentReads&) = delete;
+		ConcurrentReads& operator=(const ConcurrentReads&) = delete;
+		~ConcurrentReads()
+		{
+			for (const auto& connection : m_connections)
+				connection.m_disconnect(m_container, *connection.m_pd, connection.m_index);
+		}
+
+		//the view starts with the current value of the property
+		template<typename T>
+		[[nodiscard]] ConcurrentPropertyView<T> add(const PropertyDescriptor<T>& pd)
+		{
+			auto value = std::make_shared<ConcurrentValue<T>>(m_container.getProperty(pd).get());
+			Connection connection;
+			connection.m_pd = &pd;
+			connection.m_index = m_container.connect(pd, [value](const T& newValue) { value->store(newValue); });
+			connection.m_disconnect = +[](ContainerT& container, const PropertyDescriptorBase& pd, size_t index) {
+				container.disconnect(static_cast<const PropertyDescriptor<T>&>(pd), index);
+			};
+			m_connections.push_back(connection);
+			return ConcurrentPropertyView<T>(std::move(value));
+		}
+	};
+}
@@ -0,0 +1,334 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <tuple>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        DenseMap
+	//#
+	//############################################################################
+
+	//map for keys that carry a dense, sequential id (e.g. PropertyDescriptorBase::getId)
+	//the lookup is an index into a paged id -> slot table, no hashing is involved
+	//only the pages of the id ranges that are actually used are allocated, so a map that stores
+	//a few keys with high ids costs two bytes per 64 ids of the directory and a page per used range
+	//the values are stored in geometrically growing chunks, which means that
+	//references to values stay valid until the value is erased (same guarantee as std::unordered_map)
+	//iteration order is the order of insertion (erased slots get reused)
+	//the chunks can be allocated from a memory resource (see setMemoryResource), the id -> slot table is not
+	template<typename KeyT, typename ValueT>
+	class DenseMap
+	{
+	public:
+		using key_type = KeyT;
+		using mapped_type = ValueT;
+		using value_type = std::pair<KeyT, ValueT>;
+		using size_type = std::size_t;
+
+	private:
+		static constexpr uint32_t s_pageBits = 6;
+		static constexpr uint32_t s_pageSize = 1u << s_pageBits;
+		//id -> slot index + 1 for a range of s_pageSize ids, 0 means that the key isn't stored
+		using Page = std::array<uint32_t, s_pageSize>;
+
+		//id >> s_pageBits -> page index + 1, 0 means that no key of the range is stored
+		std::vector<uint16_t> m_directory;
+		std::vector<Page> m_pages;
+		//the chunk c holds 2^c slots, so slot s lives in chunk floor(log2(s + 1))
+		//the table only grows to the number of chunks that are in use and isn't allocated for an empty map
+		value_type** m_chunks = nullptr;
+		uint32_t m_chunkCount = 0;
+		uint32_t m_slotCount = 0;
+		std::vector<uint32_t> m_freeSlots;
+		uint32_t m_size = 0;
+		//nullptr means that the chunks are allocated via operator new
+		std::pmr::memory_resource* m_memoryResource = nullptr;
+
+		template<bool IsConst>
+		class Iterator
+		{
+			using MapT = std::conditional_t<IsConst, const DenseMap, DenseMap>;
+			MapT* m_map = nullptr;
+			uint32_t m_slot = 0;
+
+			void skipVacant() noexcept
+			{
+				while (m_slot < m_map->m_slotCount && !m_map->slotAt(m_slot).first)
+					++m_slot;
+			}
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename DenseMap::value_type;
+			using difference_type = std::ptrdiff_t;
+			using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+			using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+			Iterator() = default;
+			Iterator(MapT* map, uint32_t slot, bool skip = true) noexcept
+				: m_map(map), m_slot(slot)
+			{
+				if (skip)
+					skipVacant();
+			}
+			//allow conversion from iterator to const_iterator
+			template<bool WasConst, typename = std::enable_if_t<IsConst && !WasConst>>
+			Iterator(const Iterator<WasConst>& other) noexcept
+				: m_map(other.m_map), m_slot(other.m_slot) {}
+
+			reference operator*() const noexcept { return m_map->slotAt(m_slot); }
+			pointer operator->() const noexcept { return &m_map->slotAt(m_slot); }
+			Iterator& operator++() noexcept
+			{
+				++m_slot;
+				skipVacant();
+				return *this;
+			}
+			Iterator operator++(int) noexcept
+			{
+				auto copy = *this;
+				++*this;
+				return copy;
+			}
+			friend bool operator==(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.m_slot == rhs.m_slot; }
+			friend bool operator!=(const Iterator& lhs, const Iterator& rhs) noexcept { return lhs.m_slot != rhs.m_slot; }
+
+			template<bool> friend class Iterator;
+		};
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		DenseMap() = default;
+		DenseMap(const DenseMap& other)
+		{
+			for (const auto& [key, value] : other)
+				try_emplace(key, value);
+		}
+		DenseMap(DenseMap&& other) noexcept
+		{
+			swap(other);
+		}
+		DenseMap& operator=(DenseMap other) noexcept
+		{
+			swap(other);
+			return *this;
+		}
+		~DenseMap()
+		{
+			clear();
+		}
+
+		void swap(DenseMap& other) noexcept
+		{
+			std::swap(m_directory, other.m_directory);
+			std::swap(m_pages, other.m_pages);
+			std::swap(m_chunks, other.m_chunks);
+			std::swap(m_chunkCount, other.m_chunkCount);
+			std::swap(m_freeSlots, other.m_freeSlots);
+			std::swap(m_slotCount, other.m_slotCount);
+			std::swap(m_size, other.m_size);
+			std::swap(m_memoryResource, other.m_memoryResource);
+		}
+
+		//the memory resource can only be changed as long as no chunk has been allocated
+		//returns false if the map already allocated its storage
+		bool setMemoryResource(std::pmr::memory_resource* memoryResource) noexcept
+		{
+			if (m_chunkCount)
+				return memoryResource == m_memoryResource;
+			m_memoryResource = memoryResource;
+			return true;
+		}
+		[[nodiscard]] std::pmr::memory_resource* getMemoryResource() const noexcept
+		{
+			return m_memoryResource;
+		}
+
+		[[nodiscard]] iterator begin() noexcept { return iterator(this, 0); }
+		[[nodiscard]] iterator end() noexcept { return iterator(this, m_slotCount, false); }
+		[[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+		[[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, m_slotCount, false); }
+		[[nodiscard]] const_iterator cbegin() const noexcept { return begin(); }
+		[[nodiscard]] const_iterator cend() const noexcept { return end(); }
+
+		[[nodiscard]] size_type size() const noexcept { return m_size; }
+		[[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+		[[nodiscard]] iterator find(const KeyT& key) noexcept
+		{
+			const uint32_t slot = slotOf(key);
+			return slot ? iterator(this, slot - 1, false) : end();
+		}
+		[[nodiscard]] const_iterator find(const KeyT& key) const noexcept
+		{
+			const uint32_t slot = slotOf(key);
+			return slot ? const_iterator(this, slot - 1, false) : end();
+		}
+		[[nodiscard]] size_type count(const KeyT& key) const noexcept
+		{
+			return slotOf(key) ? 1 : 0;
+		}
+
+		ValueT& operator[](const KeyT& key)
+		{
+			return try_emplace(key).first->second;
+		}
+		ValueT& at(const KeyT& key)
+		{
+			if (const uint32_t slot = slotOf(key))
+				return slotAt(slot - 1).second;
+			throw std::out_of_range("DenseMap::at: key not found");
+		}
+		const ValueT& at(const KeyT& key) const
+		{
+			if (const uint32_t slot = slotOf(key))
+				return slotAt(slot - 1).second;
+			throw std::out_of_range("DenseMap::at: key not found");
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const KeyT& key, Args&& ... args)
+		{
+			uint32_t& indexEntry = getOrCreateIndexEntry(key->getId());
+			if (indexEntry)
+				return { iterator(this, indexEntry - 1, false), false };
+
+			uint32_t slot;
+			if (!m_freeSlots.empty())
+			{
+				slot = m_freeSlots.back();
+				m_freeSlots.pop_back();
+			}
+			else
+			{
+				slot = m_slotCount;
+				allocateSlot(slot);
+				++m_slotCount;
+			}
+			//vacant slots only hold a default constructed value
+			auto& entry = slotAt(slot);
+			if constexpr (sizeof...(Args) != 0)
+			{
+				entry.second.~ValueT();
+				::new (static_cast<void*>(std::addressof(entry.second))) ValueT(std::forward<Args>(args)...);
+			}
+			entry.first = key;
+			indexEntry = slot + 1;
+			++m_size;
+			return { iterator(this, slot, false), true };
+		}
+
+		size_type erase(const KeyT& key)
+		{
+			const uint32_t slot = slotOf(key);
+			if (!slot)
+				return 0;
+			auto& entry = slotAt(slot - 1);
+			entry.first = KeyT{};
+			entry.second.~ValueT();
+			::new (static_cast<void*>(std::addressof(entry.second))) ValueT();
+			getOrCreateIndexEntry(key->getId()) = 0;
+			m_freeSlots.push_back(slot - 1);
+			--m_size;
+			return 1;
+		}
+
+		void clear() noexcept
+		{
+			for (uint32_t chunk = 0; chunk < m_chunkCount; ++chunk)
+			{
+				const uint32_t first = (1u << chunk) - 1;
+				const uint32_t constructed = std::min(m_slotCount - first, 1u << chunk);
+				for (uint32_t i = 0; i < constructed; ++i)
+					m_chunks[chunk][i].~value_type();
+				if (m_memoryResource)
+					m_memoryResource->deallocate(m_chunks[chunk], sizeof(value_type) << chunk, alignof(value_type));
+				else
+					::operator delete(m_chunks[chunk], std::align_val_t(alignof(value_type)));
+			}
+			delete[] std::exchange(m_chunks, nullptr);
+			m_chunkCount = 0;
+			m_directory.clear();
+			m_pages.clear();
+			m_freeSlots.clear();
+			m_slotCount = 0;
+			m_size = 0;
+		}
+
+	private:
+		uint32_t slotOf(const KeyT& key) const noexcept
+		{
+			const auto id = key->getId();
+			const size_t page = id >> s_pageBits;
+			if (page >= m_directory.size() || !m_directory[page])
+				return 0;
+			return m_pages[m_directory[page] - 1][id & (s_pageSize - 1)];
+		}
+
+		uint32_t& getOrCreateIndexEntry(uint32_t id)
+		{
+			const size_t page = id >> s_pageBits;
+			if (page >= m_directory.size())
+				m_directory.resize(page + 1, 0);
+			if (!m_directory[page])
+			{
+				if (m_pages.size() >= std::numeric_limits<uint16_t>::max())
+					throw std::length_error("DenseMap: too many id pages");
+				m_pages.emplace_back().fill(0);
+				m_directory[page] = static_cast<uint16_t>(m_pages.size());
+			}
+			return m_pages[m_directory[page] - 1][id & (s_pageSize - 1)];
+		}
+
+		//floor(log2(slot + 1)), the index of the highest set bit
+		static uint32_t chunkOf(uint32_t slot) noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			unsigned long bit = 0;
+			_BitScanReverse(&bit, slot + 1);
+			return static_cast<uint32_t>(bit);
+#else
+			return 31u - static_cast<uint32_t>(__builtin_clz(slot + 1));
+#endif
+		}
+
+		value_type& slotAt(uint32_t slot) const noexcept
+		{
+			const uint32_t chunk = chunkOf(slot);
+			return m_chunks[chunk][slot + 1 - (1u << chunk)];
+		}
+
+		void allocateSlot(uint32_t slot)
+		{
+			const uint32_t chunk = chunkOf(slot);
+			if (chunk == m_chunkCount)
+			{
+				auto chunks = std::make_unique<value_type*[]>(chunk + 1);
+				std::copy(m_chunks, m_chunks + m_chunkCount, chunks.get());
+				chunks[chunk] = static_cast<value_type*>(m_memoryResource
+					? m_memoryResource->allocate(sizeof(value_type) << chunk, alignof(value_type))
+					: ::operator new(sizeof(value_type) << chunk, std::align_val_t(alignof(value_type))));
+				delete[] std::exchange(m_chunks, chunks.release());
+				++m_chunkCount;
+			}
+			::new (static_cast<void*>(&slotAt(slot))) value_type(std::piecewise_construct, std::forward_as_tuple(), std::forward_as_tuple());
+		}
+	};
+}
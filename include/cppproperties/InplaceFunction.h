@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        InplaceFunction
+	//#
+	//############################################################################
+
+	//type erased callable similar to std::function, but callables with a capture of up to
+	//Capacity bytes are stored inline, so connecting a typical lambda doesn't allocate
+	//bigger callables (or ones that might throw when moved) fall back to the heap
+	template<typename Signature, size_t Capacity = 4 * sizeof(void*)>
+	class InplaceFunction;
+
+	template<typename R, typename... Args, size_t Capacity>
+	class InplaceFunction<R(Args...), Capacity>
+	{
+		enum class Operation { Copy, Move, Destroy };
+		using InvokeT = R(*)(void*, Args&&...);
+		using ManageT = void(*)(Operation, void* dst, void* src);
+
+		template<typename FuncT>
+		static constexpr bool s_storedInline = sizeof(FuncT) <= Capacity
+			&& alignof(FuncT) <= alignof(std::max_align_t)
+			&& std::is_nothrow_move_constructible_v<FuncT>;
+
+		alignas(std::max_align_t) unsigned char m_storage[Capacity];
+		InvokeT m_invoke = nullptr;
+		ManageT m_manage = nullptr;
+
+		template<typename FuncT>
+		static FuncT* target(void* storage) noexcept
+		{
+			if constexpr (s_storedInline<FuncT>)
+				return std::launder(static_cast<FuncT*>(storage));
+			else
+				return *static_cast<FuncT**>(storage);
+		}
+
+		template<typename FuncT>
+		static R invoke(void* storage, Args&&... args)
+		{
+			return (*target<FuncT>(storage))(std::forward<Args>(args)...);
+		}
+
+		template<typename FuncT>
+		static void manage(Operation operation, void* dst, void* src)
+		{
+			switch (operation)
+			{
+			case Operation::Copy:
+				if constexpr (s_storedInline<FuncT>)
+					::new (dst) FuncT(*target<FuncT>(src));
+				else
+					::new (dst) FuncT*(new FuncT(*target<FuncT>(src)));
+				break;
+			case Operation::Move:
+				if constexpr (s_storedInline<FuncT>)
+				{
+					::new (dst) FuncT(std::move(*target<FuncT>(src)));
+					target<FuncT>(src)->~FuncT();
+				}
+				else
+					::new (dst) FuncT*(target<FuncT>(src));
+				break;
+			case Operation::Destroy:
+				if constexpr (s_storedInline<FuncT>)
+					target<FuncT>(dst)->~FuncT();
+				else
+					delete target<FuncT>(dst);
+				break;
+			}
+		}
+
+	public:
+		InplaceFunction() noexcept = default;
+
+		template<typename FuncT, typename DecayedT = std::decay_t<FuncT>,
+			typename = std::enable_if_t<!std::is_same_v<DecayedT, InplaceFunction> && std::is_invocable_r_v<R, DecayedT&, Args...>>>
+		InplaceFunction(FuncT&& func)
+		{
+			if constexpr (s_storedInline<DecayedT>)
+				::new (static_cast<void*>(m_storage)) DecayedT(std::forward<FuncT>(func));
+			else
+				::new (static_cast<void*>(m_storage)) DecayedT*(new DecayedT(std::forward<FuncT>(func)));
+			m_invoke = &invoke<DecayedT>;
+			m_manage = &manage<DecayedT>;
+		}
+
+		InplaceFunction(const InplaceFunction& other)
+			: m_invoke(other.m_invoke), m_manage(other.m_manage)
+		{
+			if (m_manage)
+				m_manage(Operation::Copy, m_storage, const_cast<unsigned char*>(other.m_storage));
+		}
+
+		InplaceFunction(InplaceFunction&& other) noexcept
+			: m_invoke(other.m_invoke), m_manage(other.m_manage)
+		{
+			if (m_manage)
+				m_manage(Operation::Move, m_storage, other.m_storage);
+			other.m_invoke = nullptr;
+			other.m_manage = nullptr;
+		}
+
+		InplaceFunction& operator=(const InplaceFunction& other)
+		{
+			if (this != &other)
+			{
+				InplaceFunction copy(other);
+				*this = std::move(copy);
+			}
+			return *this;
+		}
+
+		InplaceFunction& operator=(InplaceFunction&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				m_invoke = other.m_invoke;
+				m_manage = other.m_manage;
+				if (m_manage)
+					m_manage(Operation::Move, m_storage, other.m_storage);
+				other.m_invoke = nullptr;
+				other.m_manage = nullptr;
+			}
+			return *this;
+		}
+
+		~InplaceFunction()
+		{
+			reset();
+		}
+
+		void reset() noexcept
+		{
+			if (m_manage)
+				m_manage(Operation::Destroy, m_storage, nullptr);
+			m_invoke = nullptr;
+			m_manage = nullptr;
+		}
+
+		explicit operator bool() const noexcept
+		{
+			return m_invoke != nullptr;
+		}
+
+		R operator()(Args... args) const
+		{
+			return m_invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+		}
+	};
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        MpscStack
+	//#
+	//############################################################################
+
+	//intrusive lock free stack for multiple producers and a single consumer
+	//the nodes need a NodeT* m_next member, pushing never allocates and the consumer
+	//takes all the nodes at once, so there is no ABA problem
+	template<typename NodeT>
+	class MpscStack
+	{
+		std::atomic<NodeT*> m_head{ nullptr };
+	public:
+		MpscStack() = default;
+		MpscStack(const MpscStack&) = delete;
+		MpscStack& operator=(const MpscStack&) = delete;
+		//moving is only allowed while there are no concurrent producers
+		MpscStack(MpscStack&& other) noexcept
+			: m_head(other.m_head.exchange(nullptr, std::memory_order_acq_rel)) {}
+		//the nodes of this stack have to be consumed before
+		MpscStack& operator=(MpscStack&& other) noexcept
+		{
+			assert(empty());
+			if (this != &other)
+				m_head.store(other.m_head.exchange(nullptr, std::memory_order_acq_rel), std::memory_order_release);
+			return *this;
+		}
+
+		//can be called from any thread
+		void push(NodeT* node) noexcept
+		{
+			node->m_next = m_head.load(std::memory_order_relaxed);
+			while (!m_head.compare_exchange_weak(node->m_next, node, std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		//takes all the nodes, the most recently pushed node comes first
+		//must only be called by the consumer
+		[[nodiscard]] NodeT* takeAll() noexcept
+		{
+			return m_head.exchange(nullptr, std::memory_order_acquire);
+		}
+
+		bool empty() const noexcept
+		{
+			return m_head.load(std::memory_order_relaxed) == nullptr;
+		}
+	};
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "PropertySystem_forward.h"
+#include "ChangePolicy.h"
 #include "Signal.h"
 
 namespace ps
@@ -18,6 +19,8 @@ namespace ps
 	private:
 		Signal<const T&> m_signal;
 		T m_value{};
+		//nullptr compares the values with operator !=, the policy is not owned by the property
+		const ChangePolicy<T>* m_changePolicy = nullptr;
 	public:
 		using value_type = T;
 
@@ -32,6 +35,11 @@ namespace ps
 			set(rhs);
 			return *this;
 		}
+		Property<T>& operator=(T&& rhs)
+		{
+			set(std::move(rhs));
+			return *this;
+		}
 
 		// connect to a signal which is fired when the internal value
 		// has been changed. The new value is passed as parameter.
@@ -58,13 +66,49 @@ namespace ps
 
 		// sets the Property to a new value.
 		// on_change() will be emitted.
+		// an rvalue is moved into the property, the change policy decides if it's a change
 		template<typename U>
 		void set(U&& value)
 		{
-			if (value != m_value) {
-				m_value = std::forward<U>(value);
-				m_signal.emit(m_value);
+			if (!m_changePolicy)
+			{
+				//values that can't be compared are always a change
+				if constexpr (!is_inequality_comparable_v<U, T>) {
+					m_value = std::forward<U>(value);
+					m_signal.emit(m_value);
+				}
+				else if (value != m_value) {
+					m_value = std::forward<U>(value);
+					m_signal.emit(m_value);
+				}
 			}
+			else if constexpr (std::is_same_v<std::decay_t<U>, T>)
+			{
+				if (m_changePolicy->hasChanged(m_value, value)) {
+					m_value = std::forward<U>(value);
+					m_signal.emit(m_value);
+				}
+			}
+			else
+			{
+				//the policy compares values of type T, so other types are converted first
+				T newValue(std::forward<U>(value));
+				if (m_changePolicy->hasChanged(m_value, newValue)) {
+					m_value = std::move(newValue);
+					m_signal.emit(m_value);
+				}
+			}
+		}
+
+		// the policy has to outlive the property, nullptr restores the comparison with operator !=
+		void setChangePolicy(const ChangePolicy<T>* changePolicy) noexcept
+		{
+			m_changePolicy = changePolicy;
+		}
+
+		[[nodiscard]] const ChangePolicy<T>* getChangePolicy() const noexcept
+		{
+			return m_changePolicy;
 		}
 
 		// returns the internal value
@@ -1,19 +1,32 @@
 #pragma once
 
+#include "DenseMap.h"
 #include "PropertyDescriptor.h"
 #include "Property.h"
+#include "PropertyHandle.h"
+#include "MpscStack.h"
 #include "Signal.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <cassert>
 #include <type_traits>
 #include <typeinfo>
 #include <typeindex>
 #include <utility>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 #include <functional>
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
 
+//the maximum size of a trivially copyable value that is stored inline in the property data of a container
+//larger values and proxy properties are allocated separately
+#ifndef CPPPROPERTIES_INLINE_VALUE_SIZE
+#define CPPPROPERTIES_INLINE_VALUE_SIZE 16
+#endif
+
 namespace ps
 {
 	//###########################################################################
@@ -22,18 +35,155 @@ namespace ps
 	//#
 	//############################################################################
 
+	//binds the PropertyInputSetter of the value type T (see setPropertyByName), it's bound before main for every
+	//value type whose properties are read or set somewhere in the program, the container is a template parameter,
+	//so the setter is only instantiated once PropertyContainer is complete
+	template<typename T, typename ContainerT = PropertyContainer>
+	struct PropertyInputBinder
+	{
+		static bool setFromInput(ContainerT& container, const PropertyDescriptorBase& pd, const PropertyInput& input)
+		{
+			T value{};
+			if (!parsePropertyInput(input, value))
+				return false;
+			container.setProperty(static_cast<const PropertyDescriptor<T>&>(pd), std::move(value));
+			return true;
+		}
+		static inline const bool s_isBound = (PropertyInputSetter<T>::s_setFromInput = &setFromInput, true);
+	};
+
 	template<template<typename ...> class MapT>
 	class PropertyContainerBase
 	{
+	public:
+		//receives the changes of all the properties of a hierarchy, e.g. to mirror it into another process (see ChangeJournal)
+		//proxy properties aren't reported, since they are computed from the other properties
+		class ChangeListener
+		{
+		public:
+			//called for every changed property of the container when it's emitted, value points to the new value
+			//a property that is set without changing its value (e.g. to the default value) is reported right away
+			virtual void onPropertyChanged(const PropertyContainerBase& container, const PropertyDescriptorBase& pd, const void* value) = 0;
+			//called when the property is removed from the container
+			virtual void onPropertyRemoved(const PropertyContainerBase& container, const PropertyDescriptorBase& pd) = 0;
+			//called after the child was added to the parent, the child might already have properties and children
+			virtual void onChildAdded(const PropertyContainerBase& parent, const PropertyContainerBase& child) = 0;
+			//called before the child is removed from the parent (see removeChild)
+			virtual void onChildRemoved(const PropertyContainerBase& parent, const PropertyContainerBase& child) = 0;
+			//called before the child is moved to the new parent within the same hierarchy (see reparent)
+			virtual void onChildMoved(const PropertyContainerBase& child, const PropertyContainerBase& newParent) = 0;
+		protected:
+			~ChangeListener() = default;
+		};
 	protected:
+		//a signal of a container somewhere below the owning container of a PD
+		//we need the container to know on which instance a PMF has to be invoked
+		//and to find out where the signal has to be routed when the ownership changes
+		struct ConnectedSignal
+		{
+			PropertyContainerBase* m_container = nullptr;
+			Signal_PMF* m_signal = nullptr;
+		};
+
+		//changes whenever a container of the hierarchy might resolve a PD to a different property, see PropertyHandle
+		//shared with the handles, so a handle can still check it after the container moved to another hierarchy
+		struct HierarchyGeneration
+		{
+			std::atomic<uint64_t> m_value{ 1 };
+			//only changes when a container is added to or removed from the hierarchy, see getStructureGeneration
+			std::atomic<uint64_t> m_structure{ 1 };
+		};
+
+		struct InlineValue
+		{
+			alignas(void*) unsigned char m_bytes[CPPPROPERTIES_INLINE_VALUE_SIZE];
+		};
+		static constexpr size_t s_inlinePropertySize = sizeof(Property<InlineValue>);
+		template<typename T>
+		static constexpr bool s_isStoredInline = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(InlineValue)
+			&& sizeof(Property<T>) <= s_inlinePropertySize && alignof(Property<T>) <= alignof(void*);
+
+		//the properties of small values are constructed in the slots of this pool instead of being allocated one by one
+		//so only the containers that actually store such a property pay for the slots, the property data just refers to them
+		//the slots never move and freed slots are reused, the blocks grow geometrically and are released with the pool
+		class InlinePropertyPool
+		{
+			union Slot
+			{
+				Slot* m_nextFree;
+				alignas(void*) unsigned char m_bytes[s_inlinePropertySize];
+			};
+			struct Block
+			{
+				Block* m_next;
+				//the resource the block was allocated from, the one of the container might change afterwards
+				std::pmr::memory_resource* m_memoryResource;
+				uint32_t m_slotCount;
+			};
+			static constexpr uint32_t s_maxSlotsPerBlock = 64;
+			static constexpr size_t s_slotOffset = (sizeof(Block) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+
+			Block* m_blocks = nullptr;
+			Slot* m_freeSlots = nullptr;
+		public:
+			InlinePropertyPool() = default;
+			InlinePropertyPool(InlinePropertyPool&& other) noexcept
+				: m_blocks(std::exchange(other.m_blocks, nullptr))
+				, m_freeSlots(std::exchange(other.m_freeSlots, nullptr)) {}
+			InlinePropertyPool& operator=(InlinePropertyPool&& other) noexcept
+			{
+				std::swap(m_blocks, other.m_blocks);
+				std::swap(m_freeSlots, other.m_freeSlots);
+				return *this;
+			}
+			//the properties in the slots have to be destroyed before
+			~InlinePropertyPool()
+			{
+				while (m_blocks)
+				{
+					auto* block = std::exchange(m_blocks, m_blocks->m_next);
+					const size_t size = s_slotOffset + sizeof(Slot) * block->m_slotCount;
+					if (block->m_memoryResource)
+						block->m_memoryResource->deallocate(block, size, alignof(Slot));
+					else
+						::operator delete(block);
+				}
+			}
+
+			void* allocate(std::pmr::memory_resource* memoryResource)
+			{
+				if (!m_freeSlots)
+					allocateBlock(memoryResource);
+				return std::exchange(m_freeSlots, m_freeSlots->m_nextFree);
+			}
+			void deallocate(void* slot) noexcept
+			{
+				auto* freeSlot = ::new (slot) Slot;
+				freeSlot->m_nextFree = std::exchange(m_freeSlots, freeSlot);
+			}
+		private:
+			void allocateBlock(std::pmr::memory_resource* memoryResource)
+			{
+				const uint32_t slotCount = m_blocks ? std::min(m_blocks->m_slotCount * 2, s_maxSlotsPerBlock) : 1;
+				const size_t size = s_slotOffset + sizeof(Slot) * slotCount;
+				void* storage = memoryResource ? memoryResource->allocate(size, alignof(Slot)) : ::operator new(size);
+				m_blocks = ::new (storage) Block{ m_blocks, memoryResource, slotCount };
+				auto* slots = reinterpret_cast<Slot*>(static_cast<unsigned char*>(storage) + s_slotOffset);
+				for (uint32_t i = slotCount; i-- > 0;)
+					deallocate(&slots[i]);
+			}
+		};
+
 		struct PropertyData
 		{
 			//the property doesn't have to be set, there could only be observers to this property 
 			//using a shared_ptr is intentional, since a property can also be a 
 			//proxy property which has internal shared ownership with the m_children
 			std::shared_ptr<PropertyBase> m_property{};
-			//we need a way to signal all connected signals the default value in case a property is removed
-			std::vector<Signal_PMF*> m_connectedSignals{};
+			//all the signals that are connected to this PD and resolve to this container
+			//(either because we own the property or because we are the root and nobody owns it)
+			//we need them to signal the default value in case a property is removed
+			std::vector<ConnectedSignal> m_connectedSignals{};
 			//the signal can be connected to for a delayed notification when this property has changed
 			Signal_PMF m_signal{};
 			//using a bool to indicate if this property is a proxy property saves a dynamic cast
@@ -42,34 +192,114 @@ namespace ps
 			bool m_propertyChanged = false;
 			//currently this is my solution for decoupling the property from the property container
 			//if we want the property data to be copyable we need to be able to copy them in a type erased way
-			void(*m_copyTypeErased)(std::shared_ptr<PropertyBase>, std::shared_ptr<PropertyContainer>, PropertyContainer *, const PropertyDescriptorBase *) = nullptr;
+			void(*m_copyTypeErased)(std::shared_ptr<PropertyBase>, std::shared_ptr<PropertyContainerBase>, PropertyContainerBase*, const PropertyDescriptorBase *) = nullptr;
 			//we need to store a pointer to the type erased value of the property, 
 			//this will be cast to the correct type when needed
 			const void* m_valuePtr = nullptr;
+			//small values are stored in the InlinePropertyPool of the container, m_property doesn't own them then
+			bool m_isInlineProperty = false;
+			//copies of a container share the properties with the original until one of them changes the value (copy on write)
+			//borrowed: the property was created by another container, so it has to be copied before it's changed
+			//shared: the property was lent to a copy, it only has to be copied if the copy still uses it
+			bool m_isBorrowedProperty = false;
+			mutable bool m_isSharedProperty = false;
+			//the property is a member of a StaticPropertyContainer, it can't be removed or replaced by a proxy property
+			bool m_isStaticProperty = false;
+			//set if the property can be shared with a copy (only separately allocated, copyable properties)
+			void(*m_shareTypeErased)(const PropertyData&, PropertyData&, PropertyContainerBase*, const PropertyDescriptorBase*) = nullptr;
+			//the PD of the property, so a changed property can be reported to the ChangeListener
+			const PropertyDescriptorBase* m_pd = nullptr;
 
 			PropertyData() = default;
-			PropertyData(PropertyData&&) = default;
-			PropertyData& operator=(PropertyData&&) = default;
+			//the address of the property data has to stay stable once it holds a property (the dirty slot refers to it)
+			//so only property data with separately allocated properties are moved (e.g. the removed properties)
+			PropertyData(PropertyData&& other) noexcept
+				: m_property(std::move(other.m_property))
+				, m_connectedSignals(std::move(other.m_connectedSignals))
+				, m_signal(std::move(other.m_signal))
+				, m_isProxyProperty(other.m_isProxyProperty)
+				, m_propertyChanged(other.m_propertyChanged)
+				, m_copyTypeErased(other.m_copyTypeErased)
+				, m_valuePtr(other.m_valuePtr)
+				, m_isBorrowedProperty(other.m_isBorrowedProperty)
+				, m_isSharedProperty(other.m_isSharedProperty)
+				, m_isStaticProperty(other.m_isStaticProperty)
+				, m_shareTypeErased(other.m_shareTypeErased)
+				, m_pd(other.m_pd)
+			{
+				assert(!other.m_isInlineProperty);
+			}
+			PropertyData& operator=(PropertyData&&) = delete;
 			//it's safer to completely disable the copy constructor and copy via m_copyTypeErased
 			PropertyData(const PropertyData& other) = delete;
+			//the property data is only destroyed together with the container, which releases the pool afterwards
+			~PropertyData()
+			{
+				resetProperty(nullptr);
+			}
+
+			template<typename T>
+			std::shared_ptr<Property<T>> constructInlineProperty(PropertyContainerBase& container)
+			{
+				static_assert(s_isStoredInline<T>);
+				resetProperty(&container);
+				auto* property = ::new (container.m_inlineProperties.allocate(container.m_memoryResource)) Property<T>();
+				m_isInlineProperty = true;
+				m_property = std::shared_ptr<Property<T>>(std::shared_ptr<Property<T>>(), property);
+				return std::static_pointer_cast<Property<T>>(m_property);
+			}
+
+			//the slot of an inline property is returned to the pool of the container (if one is given)
+			void resetProperty(PropertyContainerBase* container) noexcept
+			{
+				if (!m_property)
+					return;
+				if (std::exchange(m_isInlineProperty, false))
+				{
+					auto* property = m_property.get();
+					property->~PropertyBase();
+					if (container)
+						container->m_inlineProperties.deallocate(property);
+				}
+				m_property = nullptr;
+				m_isBorrowedProperty = false;
+				m_isSharedProperty = false;
+				if (container)
+					container->nextGenerationInternal();
+			}
 
 			template<typename T, typename PP = ProxyProperty<T>>
-			void init(std::shared_ptr<Property<T>> propertyPtr, PropertyContainer* parentPtr, const PropertyDescriptorBase* pd)
+			void init(std::shared_ptr<Property<T>> propertyPtr, PropertyContainerBase* parentPtr, const PropertyDescriptorBase* pd)
 			{
+				//an inline property that is replaced by a property that lives somewhere else
+				if (m_isInlineProperty && static_cast<PropertyBase*>(propertyPtr.get()) != m_property.get())
+					resetProperty(parentPtr);
+				m_isBorrowedProperty = false;
+				m_isSharedProperty = false;
+				//properties the container doesn't own (inline or static properties) can't be shared
+				m_shareTypeErased = nullptr;
+				if constexpr (std::is_copy_constructible_v<T>)
+				{
+					if (propertyPtr.use_count() > 0)
+						m_shareTypeErased = &sharePropertyInternal<T>;
+				}
                 m_valuePtr = &propertyPtr->get();
+				m_pd = pd;
                 (*propertyPtr).connect([propertyDataPtr = this, parentPtr](const T&) { parentPtr->setDirty(*propertyDataPtr); });
 				//for each property we have to store how it can be copied
-				m_copyTypeErased = +[](std::shared_ptr<PropertyBase> property, std::shared_ptr<PropertyContainer> proxyProperty, PropertyContainer* parentPtr, const PropertyDescriptorBase* pd) {
+				m_copyTypeErased = +[](std::shared_ptr<PropertyBase> property, std::shared_ptr<PropertyContainerBase> proxyProperty, PropertyContainerBase* parentPtr, const PropertyDescriptorBase* pd) {
 					if (property)
 					{
+						//the copy has no children yet, so there are no signals that have to be rerouted like in setProperty
 						if constexpr (std::is_copy_constructible_v<T>)
-							parentPtr->setProperty(static_cast<const PropertyDescriptor<T>&>(*pd), std::static_pointer_cast<Property<T>>(property)->get());
+							parentPtr->changePropertyInternal(static_cast<const PropertyDescriptor<T>&>(*pd), std::static_pointer_cast<Property<T>>(property)->get());
 						else //we can't handle arbitrary non copyable properties, but we can handle std::shared_ptr and std::unique_ptr
-							parentPtr->setProperty(static_cast<const PropertyDescriptor<T>&>(*pd), std::make_unique<typename T::element_type>(*std::static_pointer_cast<Property<T>>(property)->get()));
+							parentPtr->changePropertyInternal(static_cast<const PropertyDescriptor<T>&>(*pd), std::make_unique<typename T::element_type>(*std::static_pointer_cast<Property<T>>(property)->get()));
 					}
 					else if (proxyProperty)
 					{
-						if constexpr (std::is_copy_constructible_v<T>)
+						//proxy properties can only be stored in containers of the same storage backend
+						if constexpr (std::is_copy_constructible_v<T> && std::is_base_of_v<PropertyContainerBase, PP>)
 						{
 							parentPtr->setProperty(static_cast<const PropertyDescriptor<T>&>(*pd), std::make_shared<PP>(*std::static_pointer_cast<PP>(proxyProperty)));
 						}
@@ -77,44 +307,187 @@ namespace ps
 					}
 				};
                 m_property = std::move(propertyPtr);
+				parentPtr->nextGenerationInternal();
+			}
+
+			template<typename T>
+			static void sharePropertyInternal(const PropertyData& from, PropertyData& to, PropertyContainerBase* parentPtr, const PropertyDescriptorBase* pd)
+			{
+				to.m_property = from.m_property;
+				to.m_valuePtr = from.m_valuePtr;
+				to.m_copyTypeErased = from.m_copyTypeErased;
+				to.m_shareTypeErased = from.m_shareTypeErased;
+				to.m_pd = pd;
+				to.m_isBorrowedProperty = true;
+				from.m_isSharedProperty = true;
+				//like a copied property, the value is signaled if it differs from a default constructed one
+				const T& value = *static_cast<const T*>(to.m_valuePtr);
+				bool hasChanged = true;
+				if (const auto* changePolicy = static_cast<const PropertyDescriptor<T>*>(pd)->getChangePolicy())
+					hasChanged = changePolicy->hasChanged(T{}, value);
+				else if constexpr (is_inequality_comparable_v<T, T>)
+					hasChanged = value != T{};
+				if (hasChanged)
+					parentPtr->setDirty(to);
+			}
+
+			//a property that is used by another container as well has to be copied before it's changed
+			[[nodiscard]] bool isCopyOnWrite() const noexcept
+			{
+				return m_isBorrowedProperty || (m_isSharedProperty && m_property.use_count() > 1);
 			}
 		};
 		using KeyT = const PropertyDescriptorBase*;
+
+		//a change that was posted from another thread, see postChange
+		struct PostedChange
+		{
+			PostedChange* m_next = nullptr;
+			PropertyContainerBase* m_container = nullptr;
+			KeyT m_pd = nullptr;
+			//set if a later change of the same property in the same container was posted
+			bool m_isSuperseded = false;
+
+			virtual ~PostedChange() = default;
+			virtual void apply() = 0;
+		};
+
+		template<typename T>
+		struct TypedPostedChange : PostedChange
+		{
+			T m_value;
+
+			template<typename U>
+			explicit TypedPostedChange(U&& value)
+				: m_value(std::forward<U>(value)) {}
+
+			void apply() override
+			{
+				this->m_container->changeProperty(static_cast<const PropertyDescriptor<T>&>(*this->m_pd), std::move(m_value));
+			}
+		};
+
+		//a container with pending changes, registered at the root of the hierarchy
+		//the depth is used to emit parents before their children
+		struct DirtyContainer
+		{
+			PropertyContainerBase* m_container = nullptr;
+			uint32_t m_depth = 0;
+			//the position in the registry, containers of the same depth keep the order in which they got dirty
+			uint32_t m_order = 0;
+		};
 		
+		//the slots of the properties with small values, declared before the property data,
+		//so it's destroyed after the properties in it
+		InlinePropertyPool m_inlineProperties;
 		//storage for all the properties that are set in this container
+		//there is intentionally no per container map of where a PD is owned, the owner
+		//is resolved by walking up the parent chain, which keeps the memory per container
+		//proportional to what is set / connected in the container itself
 		MapT<KeyT, PropertyData> m_propertyData;
-		//if a container has children we need to lookup on which container a certain property is set
-		MapT<KeyT, PropertyContainerBase*> m_toContainer;
 		//whenever a property is changed it will be added to this vector
 		//see also PropertyData->init and setDirty
 		std::vector<PropertyData*> m_changedProperties;
-		std::vector<std::unique_ptr<PropertyData>> m_removedProperties;
+		//the default values that still have to be signaled to the observers of removed properties
+		std::vector<PropertyData> m_removedProperties;
+		//scratch buffers for emit, they keep their capacity so a steady state emit doesn't allocate
+		std::vector<PropertyData*> m_emittingProperties;
+		InvocationSet m_invokedSlots;
+		bool m_isEmitting = false;
+		//only used at the root and at heads of independent subtrees (the registry owners):
+		//all the containers below that have pending changes, emit only visits these instead of traversing the whole tree
+		//an independent subtree shows up as a single entry in the registry of the owner above
+		std::vector<DirtyContainer> m_dirtyContainers;
+		std::vector<DirtyContainer> m_emittingContainers;
+		std::vector<PropertyContainerBase*> m_emittingSubtrees;
+		uint32_t m_emitGeneration = 0;
+		bool m_isDraining = false;
+		//see setIndependentSubtree
+		bool m_isIndependentSubtree = false;
+		//set while the container is registered in the dirty containers of its registry owner
+		bool m_isQueued = false;
+		//set while the independent subtree is registered in the dirty containers of the owner above
+		bool m_isSubtreeQueued = false;
+		//the generation of the emit of the registry owner that processed this container / subtree last
+		uint32_t m_emittedGeneration = 0;
+		uint32_t m_subtreeEmittedGeneration = 0;
 
 		//contains owned ProxyProperties as well as other owned children
 		std::vector<std::shared_ptr<PropertyContainerBase>> m_children;
 		PropertyContainerBase* m_parent = nullptr;
+		//the position within m_children of the parent, so a child can be removed in O(1)
+		size_t m_indexInParent = 0;
+		//the number of proxy properties in m_children, without them a child can be found by its index in O(1)
+		size_t m_proxyChildCount = 0;
+		//only used at the root: the changes posted from other threads, they are applied at the start of the next emit
+		MpscStack<PostedChange> m_postedChanges;
+		//only used at the root: the posted changes that were already taken from m_postedChanges, oldest first
+		//(e.g. the changes of a subtree that was attached or detached), they are applied before the ones still in the stack
+		std::vector<PostedChange*> m_deferredChanges;
+		std::vector<PostedChange*> m_applyingChanges;
+		InvocationSet m_appliedChanges;
+		//only used at the root: the containers that requested onPreEmit, see requestPreEmit
+		std::vector<PropertyContainerBase*> m_preEmitContainers;
+		std::vector<PropertyContainerBase*> m_runningPreEmits;
+		bool m_isPreEmitRequested = false;
+		//the proxy properties of this container that requested onEmit, they run before the signals of this container are emitted
+		std::vector<PropertyContainerBase*> m_emitRequests;
+		bool m_isEmitRequested = false;
+		//the properties that this container took over within the open batch, their signals are rerouted when the batch ends
+		std::vector<KeyT> m_batchedProperties;
+		uint32_t m_batchDepth = 0;
+		//set while the container is destroyed, so the children don't need to detach themselves
+		bool m_isDestroying = false;
+		//the allocations of the container (properties, property data, child containers) are done via this resource
+		//nullptr means that the global heap is used, see PropertyContainerBase(std::pmr::memory_resource*)
+		std::pmr::memory_resource* m_memoryResource = nullptr;
+		//otherwise the resource is inherited from the parent
+		bool m_hasOwnMemoryResource = false;
 		//if the key has been set then we know that this container is actually a proxy property stored via this key in another container
 		KeyT m_key = nullptr;
 		//this can be used to copy property containers type erased
-		std::shared_ptr<PropertyContainer>(*m_copyTypeErased)(std::shared_ptr<PropertyContainer>) = nullptr;
+		std::shared_ptr<PropertyContainerBase>(*m_copyTypeErased)(std::shared_ptr<PropertyContainerBase>) = nullptr;
+		//only used at the root, see setChangeListener
+		ChangeListener* m_changeListener = nullptr;
+		//only used at the root, it's created when it's needed for the first time (see getGeneration)
+		mutable std::shared_ptr<HierarchyGeneration> m_generation;
 
 	public:
 		
 		PropertyContainerBase() = default;
+		//all allocations of this container and its children (including proxy properties) that don't have their own
+		//memory resource are done via the given resource, e.g. a std::pmr::monotonic_buffer_resource for a scene
+		//that is released at once, the resource has to outlive all the containers that use it
+		//be aware that allocations done before a child is added to this container use the resource of the child
+		explicit PropertyContainerBase(std::pmr::memory_resource* memoryResource)
+			: m_memoryResource(memoryResource)
+			, m_hasOwnMemoryResource(true)
+		{
+			setMapMemoryResourceInternal();
+		}
 		//enable move constructors
 		PropertyContainerBase& operator=(PropertyContainerBase&&) = default;
 		PropertyContainerBase(PropertyContainerBase&&) = default;
 		//I don't think it makes sense to implement a copy constructor for now
 		PropertyContainerBase& operator=(const PropertyContainerBase&) = delete;
+		//a copy is a detached sibling of the original, it still sees the properties that
+		//are set at the parent levels, but it isn't part of the children of the parent
+		//the copy shares the properties with the original until one of them changes a value (copy on write),
+		//only small values that are stored inline, non copyable values and proxy properties are copied right away
 		PropertyContainerBase(const PropertyContainerBase& other)
-			: m_toContainer(other.m_toContainer)
+			: m_isIndependentSubtree(other.m_isIndependentSubtree)
+			, m_parent(other.m_parent)
+			, m_memoryResource(other.m_memoryResource)
+			, m_hasOwnMemoryResource(other.m_hasOwnMemoryResource)
 		{
-			
+			setMapMemoryResourceInternal();
 			for (auto& [pd, propertyData] : other.m_propertyData)
 			{
 				if (!propertyData.m_isProxyProperty)
 				{
-					if (propertyData.m_property)
+					if (propertyData.m_shareTypeErased)
+						propertyData.m_shareTypeErased(propertyData, m_propertyData[pd], this, pd);
+					else if (propertyData.m_property)
 						propertyData.m_copyTypeErased(propertyData.m_property, nullptr, this, pd);
 					else
 						m_propertyData[pd].m_signal = propertyData.m_signal;
@@ -137,8 +510,34 @@ namespace ps
 					addChildContainerInternal(child->m_copyTypeErased(child));
 				}
 			}
+			//the copied signals still have to be routed to the container where their PD is owned
+			for (auto& [pd, propertyData] : m_propertyData)
+			{
+				if (!propertyData.m_signal.empty())
+					getSignalRoutingContainer(*pd)->addSignal(*pd, { this, &propertyData.m_signal });
+			}
+		}
+		//returns a copy of this container (and its children), e.g. to instantiate a prototype
+		//the copy is cheap, since the properties are only copied once they are changed
+		template<typename ContainerT = PropertyContainerBase>
+		[[nodiscard]] std::unique_ptr<ContainerT> clone() const
+		{
+			static_assert(std::is_base_of_v<PropertyContainerBase, ContainerT>, "The clone has to be a property container.");
+			return std::make_unique<ContainerT>(static_cast<const ContainerT&>(*this));
+		}
+
+		virtual ~PropertyContainerBase()
+		{
+			m_isDestroying = true;
+			//containers that are still visible to a parent have to remove their signals from the parent chain
+			//the changes posted to the subtree move to this container, so they are deleted below
+			if (m_parent && !m_parent->m_isDestroying)
+				m_parent->detachChildInternal(*this);
+			//changes that were posted, but never applied
+			deferPostedChanges();
+			for (auto* postedChange : m_deferredChanges)
+				delete postedChange;
 		}
-		virtual ~PropertyContainerBase() = default;
 
 		//getProperty returns the value for the provided PD
 		//if the property is not set, the default value will be returned
@@ -148,17 +547,15 @@ namespace ps
 		template<typename T>
 		[[nodiscard]] const Property<T>& getProperty(const PropertyDescriptor<T>& pd) const
 		{
-			auto containerIt = m_toContainer.find(&pd);
+			bindPropertyInputInternal<T>();
+			//first find out in which container the property is stored, then get the value from
+			//that container
+			auto* container = getOwningPropertyContainer(pd);
 			//check if a property has never been set -> return the default value
-			if (containerIt == end(m_toContainer))
-			{
+			if (!container)
 				return pd.getDefaultValue();
-			}
 
-			//first find out in which container the property is stored, then get the value from
-			//that container
-			auto& container = *containerIt->second;
-			auto propertyData = container.getPropertyInternal(pd);
+			auto propertyData = container->getPropertyInternal(pd);
 			return propertyData ? *propertyData : pd.getDefaultValue();
 		}
 		//convenience function for getProperty
@@ -168,17 +565,53 @@ namespace ps
 			return getProperty(pd);
 		}
 
+		//returns a handle that caches the property getProperty resolves to
+		//use it for properties that are read very often, e.g. every frame
+		template<typename T>
+		[[nodiscard]] PropertyHandle<T, PropertyContainerBase> handle(const PropertyDescriptor<T>& pd) const
+		{
+			return PropertyHandle<T, PropertyContainerBase>(*this, pd);
+		}
+
+		//the generation of the hierarchy this container is part of, it changes whenever a container of the hierarchy
+		//might resolve a PD to a different property than before (a property was set for the first time or removed,
+		//or the structure of the hierarchy has changed), changes in other hierarchies don't affect it
+		//the first call for a hierarchy must not run concurrently to other calls for it
+		[[nodiscard]] uint64_t getGeneration() const
+		{
+			return getHierarchyGeneration()->m_value.load(std::memory_order_relaxed);
+		}
+
+		//changes whenever a container is added to or removed from the hierarchy, e.g. the paths of child indices
+		//(see getChildContainer) that were resolved before might refer to different containers afterwards
+		//the first call for a hierarchy must not run concurrently to other calls for it
+		[[nodiscard]] uint64_t getStructureGeneration() const
+		{
+			return getHierarchyGeneration()->m_structure.load(std::memory_order_relaxed);
+		}
+
+		//the counter behind getGeneration, it stays valid after the container moved to another hierarchy
+		//(the generation of the old hierarchy has changed then)
+		[[nodiscard]] std::shared_ptr<const HierarchyGeneration> getHierarchyGeneration() const
+		{
+			const auto* root = this;
+			while (root->m_parent)
+				root = root->m_parent;
+			if (!root->m_generation)
+				root->m_generation = std::make_shared<HierarchyGeneration>();
+			return root->m_generation;
+		}
+
 		//this function should only be ever needed very rarely
 		//you should not need to interact with a proxy property directly
 		template<typename T>
 		[[nodiscard]] const ProxyProperty<T>* getProxyProperty(const PropertyDescriptor<T>& pd) const
 		{
-			auto containerIt = m_toContainer.find(&pd);
+			auto* container = getOwningPropertyContainer(pd);
 			//property has never been set -> return nullptr
-			if (containerIt == end(m_toContainer))
+			if (!container)
 				return nullptr;
-			auto& container = *containerIt->second;
-			return container.getProxyPropertyInternal(pd);
+			return container->getProxyPropertyInternal(pd);
 		}
 		//          *
 		//		  /   \
@@ -190,20 +623,73 @@ namespace ps
 		template<typename T, typename U>
 		void setProperty(const PropertyDescriptor<T>& pd, U && value)
 		{
-			//set this as new parent container for the given PD
-			setParentContainerForProperty(pd, this);
-			//construct the property here to mark that we have the ownership of this property
-			getOrConstructPropertyInternal(pd);
-			//for the case that the same property has been set at a lower (parent) level
-			//we have to update the existing subjects before changning the property
-			//otherwise the wrong subjects will be updated
-			updateAllSignals(pd);
-
-			PropertyContainerBase* parentContainer = m_parent ? m_parent->getOwningPropertyContainer(pd) : nullptr;
-			if (parentContainer)
-				parentContainer->updateAllSignals(pd);
-			
+			bindPropertyInputInternal<T>();
+			//within a batch the rerouting is done once for all properties when the batch ends
+			if (m_batchDepth)
+			{
+				if (m_parent && !ownsPropertyDataInternal(pd))
+					m_batchedProperties.push_back(&pd);
+				changePropertyInternal(pd, std::forward<U>(value));
+				return;
+			}
+			//if we take over the ownership, the signals from our subtree that were routed to the
+			//previous owner (or the root) have to be routed to this container
+			//this only touches the signals of the previous owner and not the whole subtree
+			PropertyContainerBase* previousContainer = nullptr;
+			if (m_parent && !ownsPropertyDataInternal(pd))
+				previousContainer = m_parent->getSignalRoutingContainer(pd);
+
 			changePropertyInternal(pd, std::forward<U>(value));
+
+			if (previousContainer)
+				previousContainer->rerouteSignals(pd);
+		}
+
+		//scope returned by batch(), the batch ends when the last scope of this container is destroyed
+		class Batch
+		{
+			PropertyContainerBase* m_container;
+		public:
+			explicit Batch(PropertyContainerBase& container) noexcept : m_container(&container)
+			{
+				++m_container->m_batchDepth;
+			}
+			Batch(Batch&& other) noexcept : m_container(std::exchange(other.m_container, nullptr)) {}
+			Batch(const Batch&) = delete;
+			Batch& operator=(const Batch&) = delete;
+			Batch& operator=(Batch&&) = delete;
+			~Batch()
+			{
+				if (m_container && --m_container->m_batchDepth == 0)
+					m_container->commitBatch();
+			}
+		};
+
+		//use this when a lot of properties are set on this container at once (e.g. when a configuration is loaded)
+		//setProperty has to reroute the signals of the subtree when this container takes over the ownership of a property,
+		//within a batch this is deferred until the batch ends and done for all properties with a single walk up the hierarchy
+		//{
+		//	auto batch = container.batch();
+		//	container.setProperty(IntPD, 1);
+		//	...
+		//}
+		//the hierarchy must not be emitted or restructured while a batch is open, as the signals of the subtree might not be routed yet
+		[[nodiscard]] Batch batch() noexcept
+		{
+			return Batch(*this);
+		}
+
+		//sets the property of the PD with this name, e.g. when a configuration is loaded from a file
+		//strings are parsed with the PropertyParser of the value type of the PD, numbers are converted to it
+		//returns false if there is no PD with this name or the value can't be converted
+		//a PD can only be set by name if its value type is read or set with getProperty/setProperty somewhere in the program
+		//freeze the registry after all PDs are constructed to make the name lookup cheaper (see PropertyDescriptorRegistry)
+		bool setPropertyByName(std::string_view name, const PropertyInput& value,
+			const PropertyDescriptorRegistry& registry = PropertyDescriptorRegistry::global())
+		{
+			static_assert(std::is_same_v<PropertyContainerBase, PropertyContainer>, "setting properties by name is only supported by PropertyContainer");
+			const auto* pd = registry.find(name);
+			return pd && pd->setPropertyFromInput(*this, value);
 		}
 
 		//this is the removal counterpart of the setProperty interface
@@ -213,11 +699,8 @@ namespace ps
 		template<typename T>
 		void removeProperty(const PropertyDescriptor<T>& pd)
 		{
-			auto containerIt = m_toContainer.find(&pd);
-			if (containerIt == end(m_toContainer))
-				return;
-			auto& container = *containerIt->second;
-			container.removePropertyInternal(pd);
+			if (auto* container = getOwningPropertyContainer(pd))
+				container->removePropertyInternal(pd);
 		}
 
 		//interface to check if a property has been set
@@ -226,7 +709,7 @@ namespace ps
 		template<typename T>
 		bool hasProperty(const PropertyDescriptor<T>& pd) const
 		{
-			return m_toContainer.find(&pd) != end(m_toContainer);
+			return getOwningPropertyContainer(pd) != nullptr;
 		}
 
 		//this will change the current property at the level where it was set
@@ -235,17 +718,31 @@ namespace ps
 		void changeProperty(const PropertyDescriptor<T>& pd, U&& value)
 		{
 			//find the correct container where we have to change the property
-			if (auto containerIT = m_toContainer.find(&pd); containerIT != end(m_toContainer))
-				return containerIT->second->changePropertyInternal(pd, std::forward<U>(value));
+			if (auto* container = getOwningPropertyContainer(pd))
+				return container->changePropertyInternal(pd, std::forward<U>(value));
+		}
+
+		//thread safe version of changeProperty, it can be called from any thread at any time
+		//the change is queued lock free at the root of the hierarchy and applied at the start
+		//of the next emit (on the thread calling emit), if the same property of the same container
+		//is posted multiple times before that, only the last value is applied
+		//if the container is attached or detached in the meantime, its pending changes move to the new root
+		//the hierarchy above this container must not be changed concurrently
+		template<typename T, typename U>
+		void postChange(const PropertyDescriptor<T>& pd, U&& value)
+		{
+			auto* postedChange = new TypedPostedChange<T>(std::forward<U>(value));
+			postedChange->m_container = this;
+			postedChange->m_pd = &pd;
+			getRootInternal()->m_postedChanges.push(postedChange);
 		}
 
 		//interface to trigger a property changed without changing the value
 		template<typename T>
 		void touchProperty(const PropertyDescriptor<T>& pd)
 		{
-			auto containerIt = m_toContainer.find(&pd);
-			if (containerIt != end(m_toContainer))
-				containerIt->second->touchPropertyInternal(pd);
+			if (auto* container = getOwningPropertyContainer(pd))
+				container->touchPropertyInternal(pd);
 		}
 
 		//we can connect a property to a function/lambda (or member function ptr)
@@ -259,10 +756,7 @@ namespace ps
 			using PMF = PMF_traits<FuncT>;
 			//get / construct the signal if needed
 			auto& signal = m_propertyData[&pd].m_signal;
-
-			auto containerIt = m_toContainer.find(&pd);
-			if (containerIt != end(m_toContainer))
-				containerIt->second->addSignal(pd, &signal);
+			getSignalRoutingContainer(pd)->addSignal(pd, { this, &signal });
 
 			//case 1: function object callable with argument of type T
 			if constexpr (std::is_invocable_v<FuncT, T>)
@@ -319,47 +813,113 @@ namespace ps
 		template<typename ContainerT, typename... Args>
 		[[maybe_unused]] ContainerT& addChildContainer(Args&& ...args)
 		{
-			return *static_cast<ContainerT*>(addChildContainerInternal(std::make_shared<ContainerT>(std::forward<Args>(args)...)).get());
+			return *static_cast<ContainerT*>(addReportedChildInternal(allocateSharedInternal<ContainerT>(std::forward<Args>(args)...)).get());
 		}
 
 		//use this to build the property container tree structure
 		template<typename T>
-		[[maybe_unused]] std::shared_ptr<PropertyContainerBase>& addChildContainer(std::unique_ptr<T> propertyContainer)
+		[[maybe_unused]] T& addChildContainer(std::unique_ptr<T> propertyContainer)
 		{
-			return addChildContainerInternal<T>(std::move(propertyContainer));
+			return *addReportedChildInternal<T>(toSharedInternal(std::move(propertyContainer)));
 		}
-		//the emit step looks like:
-		//1. collect all signals belonging to properties that changed since the last update
-		//2. reset the dirty flags of all the properties that changed
-		//3. remove duplicates of calls to class member functions (optional)
-		//4. get the new value
-		//5. emit the function calls of all the signals
-		//6. remove the signals that got removed
-		//7. call emit on all children
-		//TODO: add a pre and post update step?
-		void emit(bool ignoreDuplicateCalls = true)
+
+		//adds all containers of the range (of unique_ptr or shared_ptr) as children
+		//the elements are moved out of an rvalue range, the shared_ptrs of an lvalue range are copied
+		template<typename RangeT>
+		void addChildren(RangeT&& containers)
 		{
-			for (auto* dirtyProperty : m_changedProperties)
+			using ElementT = std::decay_t<decltype(*std::begin(containers))>;
+			constexpr bool isMovedFrom = !std::is_lvalue_reference_v<RangeT>;
+			static_assert(isMovedFrom || std::is_copy_constructible_v<ElementT>, "A range of unique_ptrs has to be passed as rvalue, e.g. addChildren(std::move(children)).");
+			if constexpr (std::is_same_v<typename std::iterator_traits<decltype(std::begin(containers))>::iterator_category, std::random_access_iterator_tag>)
+				m_children.reserve(m_children.size() + static_cast<size_t>(std::end(containers) - std::begin(containers)));
+			for (auto& container : containers)
 			{
-				dirtyProperty->m_propertyChanged = false;
+				if constexpr (isMovedFrom)
+					addReportedChildInternal(toSharedInternal(std::move(container)));
+				else
+					addReportedChildInternal(toSharedInternal(ElementT(container)));
 			}
+		}
 
-			if (ignoreDuplicateCalls)
-				emitEliminateDuplicates();
-			else
-				emitWithDuplicates();
-			
-			//TODO: check if we need to support duplicate signal resolving for removed properties
-			for (auto& removedProperty : m_removedProperties)
+		//detaches the child (and its subtree) from this container and hands over the ownership to the caller
+		//the child becomes the root of its own hierarchy and keeps its properties, signals and pending changes
+		//to keep this O(1) the last child container takes over the position of the removed one
+		[[maybe_unused]] std::shared_ptr<PropertyContainerBase> removeChild(PropertyContainerBase& child)
+		{
+			//proxy properties have to be removed via removeProperty
+			assert(child.m_parent == this && !child.m_key);
+			if (auto* changeListener = getChangeListenerInternal())
+				changeListener->onChildRemoved(*this, child);
+			auto childPtr = takeChildInternal(child);
+			detachChildInternal(child);
+			return childPtr;
+		}
+
+		//moves the child (and its subtree) from this container to the new parent, nothing has to be rebuilt:
+		//the subtree keeps its properties and connections, only the signals that resolve outside of it are rerouted
+		void reparent(PropertyContainerBase& child, PropertyContainerBase& newParent)
+		{
+			assert(child.m_parent == this && !child.m_key && !child.isAncestorOf(newParent));
+			auto* reportingRoot = getReportingRootInternal();
+			const bool isMovedWithinHierarchy = reportingRoot && reportingRoot == newParent.getReportingRootInternal();
+			if (auto* changeListener = getChangeListenerInternal())
 			{
-				for (auto& dirtySignal : removedProperty->m_connectedSignals)
-				{
-					dirtySignal->emit(this, removedProperty->m_valuePtr);
-				}
+				if (isMovedWithinHierarchy)
+					changeListener->onChildMoved(child, newParent);
+				else
+					changeListener->onChildRemoved(*this, child);
 			}
-			m_removedProperties.clear();
-			for (auto& child : m_children)
-				child->emit(ignoreDuplicateCalls);
+			auto childPtr = takeChildInternal(child);
+			detachChildInternal(child);
+			newParent.attachChildInternal(std::move(childPtr));
+			if (auto* changeListener = newParent.getChangeListenerInternal(); changeListener && !isMovedWithinHierarchy)
+				changeListener->onChildAdded(newParent, child);
+		}
+		//the emit step looks like:
+		//1. take the containers of this subtree that registered changes at the registry owner (usually the root)
+		//2. sort them by depth, so parents are emitted before their children
+		//3. emit the changes of each container (see emitChanges)
+		//4. emit the dirty independent subtrees (see setIndependentSubtree), each one drains its own registry
+		//5. repeat with the containers that got dirty while emitting,
+		//   a container is only emitted once per call, later changes are kept for the next emit
+		//containers without changes aren't visited at all
+		void emit(bool ignoreDuplicateCalls = true)
+		{
+			emitInternal(ignoreDuplicateCalls, nullptr);
+		}
+		//same as emit, but the dirty independent subtrees are emitted in parallel on the thread pool
+		//the order within each subtree and the duplicate elimination stay the same
+		void emit(ThreadPool& threadPool, bool ignoreDuplicateCalls = true)
+		{
+			emitInternal(ignoreDuplicateCalls, &threadPool);
+		}
+
+		//declares that the subtree of this container is independent of the rest of the hierarchy:
+		//the signals emitted within the subtree only change properties that are owned within the subtree
+		//(and don't change the structure of the hierarchy outside of it), so emit(ThreadPool&) can emit
+		//independent subtrees in parallel, properties owned above are still emitted by the owner
+		void setIndependentSubtree(bool isIndependent = true)
+		{
+			if (m_isIndependentSubtree == isIndependent)
+				return;
+			assert(!m_isDraining);
+			//the pending changes of the subtree move to the new registry owner
+			auto* previousOwner = getRegistryOwnerInternal();
+			m_isIndependentSubtree = isIndependent;
+			transferDirtyContainers(*previousOwner, *this);
+			if (m_isIndependentSubtree && !m_dirtyContainers.empty())
+				enqueueDirtySubtree();
+		}
+		bool isIndependentSubtree() const noexcept
+		{
+			return m_isIndependentSubtree;
+		}
+
+		//the memory resource that is used for the allocations of this container
+		[[nodiscard]] std::pmr::memory_resource* getMemoryResource() const noexcept
+		{
+			return m_memoryResource ? m_memoryResource : std::pmr::get_default_resource();
 		}
 		// [] begin/end/size is to make the container more stl compatible
 		//I think it's most reasonable to use the children as basis for the iterator / size
@@ -382,65 +942,508 @@ namespace ps
 		{
 			return m_children.cend();
 		}
-		
 
-	protected:
-		template<typename T>
-		[[maybe_unused]] std::shared_ptr<T> addChildContainerInternal(std::shared_ptr<T> propertyContainer)
+		//proxy properties are stored as children of the container that owns them
+		[[nodiscard]] bool isProxyProperty() const noexcept
 		{
-			propertyContainer->setParent(this);
-			//here we propagate all the pd's that we own
-			for (auto& propertyData : m_propertyData)
+			return m_key != nullptr;
+		}
+
+		//nullptr for the root (and for copies of the root)
+		[[nodiscard]] const PropertyContainerBase* getParent() const noexcept
+		{
+			return m_parent;
+		}
+
+		//the child containers are numbered in the order of cbegin / cend, proxy properties aren't counted
+		//(snapshots, the PropertyIngestor and the ChangeJournal identify containers this way)
+		//removing a child moves the last child container to its position, the proxy properties don't affect the numbering
+		//returns nullptr if there is no such child, O(1) as long as this container has no proxy properties
+		[[nodiscard]] PropertyContainerBase* getChildContainer(size_t index) const noexcept
+		{
+			if (!m_proxyChildCount)
+				return index < m_children.size() ? m_children[index].get() : nullptr;
+			for (const auto& child : m_children)
 			{
-				if (auto& pd = *propertyData.first; !propertyContainer->ownsPropertyDataInternal(pd))
-					propertyContainer->setParentContainerForProperty(pd, this);
+				if (!child->m_key && index-- == 0)
+					return child.get();
 			}
-			//here we propagate all the pd's that we don't own
-			for (auto& [pd, container] : m_toContainer)
+			return nullptr;
+		}
+
+		//the index of this container in the child containers of the parent, see getChildContainer
+		[[nodiscard]] size_t getChildIndex() const noexcept
+		{
+			if (!m_parent || !m_parent->m_proxyChildCount)
+				return m_indexInParent;
+			size_t index = 0;
+			for (size_t i = 0; i < m_indexInParent; ++i)
 			{
-				if (!propertyContainer->ownsPropertyDataInternal(*pd))
-					propertyContainer->setParentContainerForProperty(*pd, container);
+				if (!m_parent->m_children[i]->m_key)
+					++index;
 			}
-			propertyContainer->m_copyTypeErased = +[](std::shared_ptr<PropertyContainer> container) -> std::shared_ptr<PropertyContainer> {
+			return index;
+		}
+
+		//the listener gets all the changes of the hierarchy reported, it's only used while this container is the root
+		//the listener has to outlive the hierarchy or has to be reset before it's destroyed
+		void setChangeListener(ChangeListener* listener) noexcept
+		{
+			m_changeListener = listener;
+		}
+
+		[[nodiscard]] ChangeListener* getChangeListener() const noexcept
+		{
+			return m_changeListener;
+		}
+
+		//invokes func(const PropertyDescriptorBase& pd, const void* value) for every property that is owned by
+		//this container and isn't a proxy property, the value has to be cast to the value type of the PD
+		template<typename FuncT>
+		void forEachProperty(FuncT&& func) const
+		{
+			for (auto& [pd, propertyData] : m_propertyData)
+			{
+				if (propertyData.m_property && !propertyData.m_isProxyProperty)
+					func(*pd, propertyData.m_valuePtr);
+			}
+		}
+		
+
+	protected:
+		template<typename T>
+		[[maybe_unused]] std::shared_ptr<T> addChildContainerInternal(std::shared_ptr<T> propertyContainer)
+		{
+			propertyContainer->m_copyTypeErased = +[](std::shared_ptr<PropertyContainerBase> container) -> std::shared_ptr<PropertyContainerBase> {
 				if constexpr (std::is_copy_constructible_v<T>)
 					return std::make_shared<T>(*std::static_pointer_cast<T>(container));
 				else
 					return nullptr;
 			};
-			m_children.emplace_back(propertyContainer);
+			attachChildInternal(propertyContainer);
 			return propertyContainer;
 		}
-		void emitEliminateDuplicates()
+
+		//adds a child container that is reported to the change listener, unlike proxy properties and the children of a copy
+		template<typename T>
+		std::shared_ptr<T> addReportedChildInternal(std::shared_ptr<T> propertyContainer)
 		{
-			std::unordered_set<size_t> alreadyInvokedSlots;
-			//here we make a local copy, because changing a property could result in the change of another property
-			auto changedProperties = m_changedProperties;
-			m_changedProperties.clear();
-			for (auto* dirtyProperty : changedProperties)
+			addChildContainerInternal(propertyContainer);
+			if (auto* changeListener = getChangeListenerInternal())
+				changeListener->onChildAdded(*this, *propertyContainer);
+			return propertyContainer;
+		}
+
+		void attachChildInternal(std::shared_ptr<PropertyContainerBase> propertyContainer)
+		{
+			//a copied container still sees the parent of the original, we have to detach it from there first
+			if (auto* previousParent = propertyContainer->m_parent)
+				previousParent->detachChildInternal(*propertyContainer);
+			//the handles of both hierarchies have to resolve their properties again
+			propertyContainer->nextGenerationInternal(true);
+			nextGenerationInternal(true);
+			//the new child was a root, the changes posted to it are applied by the next emit of this hierarchy
+			transferPostedChanges(*propertyContainer, *getRootInternal(), *propertyContainer);
+			propertyContainer->setParent(this);
+			transferDirtyContainers(*propertyContainer, *propertyContainer);
+			transferPreEmitRequests(*propertyContainer, *propertyContainer);
+			//the new child was a root before, so it collected all the signals of its subtree
+			//that don't resolve to an owner within the subtree, those now have to be
+			//routed into this hierarchy - the rest of the subtree doesn't have to be visited
+			for (auto& [pd, propertyData] : propertyContainer->m_propertyData)
 			{
-				const void* newValue = dirtyProperty->m_valuePtr;
-				for (auto& dirtySignal : dirtyProperty->m_connectedSignals)
+				if (!propertyData.m_property && !propertyData.m_connectedSignals.empty())
+					propertyContainer->rerouteSignals(*pd);
+			}
+			propertyContainer->inheritMemoryResourceInternal(m_memoryResource);
+			propertyContainer->m_indexInParent = m_children.size();
+			if (propertyContainer->m_key)
+				++m_proxyChildCount;
+			m_children.push_back(std::move(propertyContainer));
+		}
+
+		template<typename T, typename... Args>
+		std::shared_ptr<T> allocateSharedInternal(Args&& ... args) const
+		{
+			if (m_memoryResource)
+				return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(m_memoryResource), std::forward<Args>(args)...);
+			return std::make_shared<T>(std::forward<Args>(args)...);
+		}
+
+		//at least the control block is allocated via the memory resource
+		template<typename T>
+		std::shared_ptr<T> toSharedInternal(std::unique_ptr<T> ptr) const
+		{
+			if (m_memoryResource)
+				return std::shared_ptr<T>(ptr.release(), std::default_delete<T>(), std::pmr::polymorphic_allocator<T>(m_memoryResource));
+			return std::shared_ptr<T>(std::move(ptr));
+		}
+		template<typename T>
+		std::shared_ptr<T> toSharedInternal(std::shared_ptr<T> ptr) const noexcept
+		{
+			return ptr;
+		}
+
+		void setMapMemoryResourceInternal()
+		{
+			if constexpr (std::is_same_v<MapT<KeyT, PropertyData>, DenseMap<KeyT, PropertyData>>)
+				m_propertyData.setMemoryResource(m_memoryResource);
+		}
+
+		//a new child uses the memory resource of the parent, unless it has its own
+		void inheritMemoryResourceInternal(std::pmr::memory_resource* memoryResource)
+		{
+			if (m_hasOwnMemoryResource || m_memoryResource == memoryResource)
+				return;
+			m_memoryResource = memoryResource;
+			setMapMemoryResourceInternal();
+			for (auto& child : m_children)
+				child->inheritMemoryResourceInternal(memoryResource);
+		}
+
+		//removes the child from m_children, the last child container is moved into its position
+		//the order of the other child containers doesn't depend on where the proxy properties are stored,
+		//so a replica without (or with other) proxy properties numbers its children the same way
+		std::shared_ptr<PropertyContainerBase> takeChildInternal(PropertyContainerBase& child)
+		{
+			const size_t index = child.m_indexInParent;
+			assert(index < m_children.size() && m_children[index].get() == &child);
+			auto childPtr = std::move(m_children[index]);
+			auto moveChild = [this](size_t from, size_t to) {
+				m_children[to] = std::move(m_children[from]);
+				m_children[to]->m_indexInParent = to;
+			};
+			if (child.m_key)
+			{
+				--m_proxyChildCount;
+				if (m_children.back() && m_children.back()->m_key)
+				{
+					moveChild(m_children.size() - 1, index);
+					m_children.pop_back();
+				}
+				else
+				{
+					//a child container would move in front of the others, the rare case of removing a proxy property pays for that
+					m_children.erase(m_children.begin() + static_cast<std::ptrdiff_t>(index));
+					for (size_t i = index; i < m_children.size(); ++i)
+						m_children[i]->m_indexInParent = i;
+				}
+				return childPtr;
+			}
+			size_t lastChildContainer = m_children.size() - 1;
+			while (lastChildContainer > index && m_children[lastChildContainer]->m_key)
+				--lastChildContainer;
+			if (lastChildContainer != index)
+				moveChild(lastChildContainer, index);
+			//only proxy properties are stored behind the last child container, one of them takes over its position
+			if (lastChildContainer + 1 != m_children.size())
+				moveChild(m_children.size() - 1, lastChildContainer);
+			m_children.pop_back();
+			return childPtr;
+		}
+		//called whenever this container is emitted, before the signals of its changed properties are emitted
+		//this happens if one of its properties changed or if requestEmit was called
+		virtual void onEmit() {}
+
+		//makes sure that the next emit visits this container (see onEmit), even if none of its properties changed
+		//for a proxy property onEmit is called by the container that owns it, so the value it sets in there
+		//is emitted together with the other changes of that container and not only with the next emit
+		void requestEmit()
+		{
+			if (!m_key || !m_parent)
+			{
+				enqueueDirtyContainer();
+				return;
+			}
+			if (!m_isEmitRequested)
+			{
+				m_isEmitRequested = true;
+				m_parent->m_emitRequests.push_back(this);
+			}
+			m_parent->enqueueDirtyContainer();
+		}
+
+		//called at the start of the next emit of the hierarchy, before any signal is emitted,
+		//once requestPreEmit was called, e.g. to publish results that were computed asynchronously
+		virtual void onPreEmit() {}
+
+		//requests a single onPreEmit call at the start of the next emit, this can be called from within onPreEmit again
+		void requestPreEmit()
+		{
+			if (m_isPreEmitRequested)
+				return;
+			m_isPreEmitRequested = true;
+			getRootInternal()->m_preEmitContainers.push_back(this);
+		}
+
+		void runPreEmits()
+		{
+			//the running requests are kept separately, so the new requests are kept for the next emit
+			if (m_preEmitContainers.empty() || !m_runningPreEmits.empty())
+				return;
+			m_runningPreEmits.swap(m_preEmitContainers);
+			//indexed on purpose, onPreEmit might detach containers (see transferPreEmitRequests)
+			for (size_t i = 0; i < m_runningPreEmits.size(); ++i)
+			{
+				if (auto* container = m_runningPreEmits[i])
+				{
+					container->m_isPreEmitRequested = false;
+					container->onPreEmit();
+				}
+			}
+			m_runningPreEmits.clear();
+		}
+
+		//moves the pre emit requests of the given subtree from the root 'from' to the current root of the subtree
+		static void transferPreEmitRequests(PropertyContainerBase& from, PropertyContainerBase& subtree)
+		{
+			std::vector<PropertyContainerBase*> moved;
+			auto& requests = from.m_preEmitContainers;
+			requests.erase(std::remove_if(begin(requests), end(requests), [&subtree, &moved](PropertyContainerBase* container) {
+				if (!subtree.isAncestorOf(*container))
+					return false;
+				moved.push_back(container);
+				return true;
+			}), end(requests));
+			for (auto*& container : from.m_runningPreEmits)
+			{
+				if (container && container->m_isPreEmitRequested && subtree.isAncestorOf(*container))
+				{
+					moved.push_back(container);
+					container = nullptr;
+				}
+			}
+			for (auto* container : moved)
+			{
+				container->m_isPreEmitRequested = false;
+				container->requestPreEmit();
+			}
+		}
+
+		void emitInternal(bool ignoreDuplicateCalls, ThreadPool* threadPool)
+		{
+			auto* root = getRootInternal();
+			root->applyPostedChanges();
+			root->runPreEmits();
+			auto* owner = getRegistryOwnerInternal();
+			owner->drainDirtyContainers(owner == this ? nullptr : this, ignoreDuplicateCalls, threadPool);
+			//changes that were deferred to the next emit have to be visible to the owner above
+			if (!owner->m_dirtyContainers.empty())
+				owner->enqueueDirtySubtree();
+		}
+
+		//emits the containers registered at this registry owner, restricted to the given subtree (if any)
+		void drainDirtyContainers(const PropertyContainerBase* subtree, bool ignoreDuplicateCalls, ThreadPool* threadPool)
+		{
+			//emit was called from within a slot, the running emit will pick up the new changes
+			if (m_isDraining)
+				return;
+			m_isDraining = true;
+			const uint32_t generation = ++m_emitGeneration;
+			auto& wave = m_emittingContainers;
+			auto& subtrees = m_emittingSubtrees;
+			try
+			{
+				while (true)
+				{
+					auto keepIt = begin(m_dirtyContainers);
+					for (auto& dirty : m_dirtyContainers)
+					{
+						auto* container = dirty.m_container;
+						const bool isSubtree = container != this && container->m_isIndependentSubtree;
+						const uint32_t emittedGeneration = isSubtree ? container->m_subtreeEmittedGeneration : container->m_emittedGeneration;
+						if (emittedGeneration != generation && (!subtree || subtree->isAncestorOf(*container)))
+							wave.push_back({ container, dirty.m_depth, static_cast<uint32_t>(wave.size()) });
+						else
+							*keepIt++ = dirty;
+					}
+					m_dirtyContainers.erase(keepIt, end(m_dirtyContainers));
+					if (wave.empty())
+						break;
+					//std::stable_sort would allocate a temporary buffer
+					std::sort(begin(wave), end(wave), [](const DirtyContainer& lhs, const DirtyContainer& rhs) {
+						return lhs.m_depth != rhs.m_depth ? lhs.m_depth < rhs.m_depth : lhs.m_order < rhs.m_order;
+					});
+					//indexed on purpose, a slot might detach containers of the wave (see transferDirtyContainers)
+					for (size_t i = 0; i < wave.size(); ++i)
+					{
+						auto* container = wave[i].m_container;
+						if (!container)
+							continue;
+						if (container != this && container->m_isIndependentSubtree)
+						{
+							container->m_isSubtreeQueued = false;
+							container->m_subtreeEmittedGeneration = generation;
+							subtrees.push_back(container);
+							continue;
+						}
+						container->m_isQueued = false;
+						container->m_emittedGeneration = generation;
+						container->emitChanges(ignoreDuplicateCalls);
+					}
+					wave.clear();
+					//the independent subtrees are emitted after the containers above them
+					if (threadPool && subtrees.size() > 1)
+					{
+						threadPool->parallelFor(subtrees.size(), [&subtrees, ignoreDuplicateCalls, threadPool](size_t i) {
+							subtrees[i]->drainDirtyContainers(nullptr, ignoreDuplicateCalls, threadPool);
+						});
+					}
+					else
+					{
+						for (size_t i = 0; i < subtrees.size(); ++i)
+						{
+							if (subtrees[i])
+								subtrees[i]->drainDirtyContainers(nullptr, ignoreDuplicateCalls, threadPool);
+						}
+					}
+					//changes that were deferred within a subtree are registered again at this level
+					for (auto* independentSubtree : subtrees)
+					{
+						if (independentSubtree && !independentSubtree->m_dirtyContainers.empty())
+							independentSubtree->enqueueDirtySubtree();
+					}
+					subtrees.clear();
+				}
+			}
+			catch (...)
+			{
+				//a slot threw, the containers that weren't emitted yet stay registered for the next emit,
+				//the rest of the changes of the container that threw is dropped
+				m_isDraining = false;
+				for (const auto& entry : wave)
+				{
+					auto* container = entry.m_container;
+					if (!container)
+						continue;
+					const bool isSubtree = container != this && container->m_isIndependentSubtree;
+					if ((isSubtree ? container->m_subtreeEmittedGeneration : container->m_emittedGeneration) != generation)
+						m_dirtyContainers.push_back(entry);
+					else if (!isSubtree)
+					{
+						container->m_isEmitting = false;
+						container->m_emittingProperties.clear();
+					}
+				}
+				wave.clear();
+				for (auto* independentSubtree : subtrees)
+				{
+					if (independentSubtree && !independentSubtree->m_dirtyContainers.empty())
+						independentSubtree->enqueueDirtySubtree();
+				}
+				subtrees.clear();
+				if (!m_dirtyContainers.empty())
+					enqueueDirtySubtree();
+				throw;
+			}
+			m_isDraining = false;
+		}
+
+		//emits the changed and removed properties of this container only
+		void emitChanges(bool ignoreDuplicateCalls)
+		{
+			runEmitRequests();
+			onEmit();
+			auto* changeListener = getChangeListenerInternal();
+			do
+			{
+				for (auto* dirtyProperty : m_changedProperties)
 				{
-					dirtySignal->emitUnique(this, newValue, alreadyInvokedSlots);
+					dirtyProperty->m_propertyChanged = false;
+					//the property might have been removed since it changed
+					if (changeListener && dirtyProperty->m_property && !dirtyProperty->m_isProxyProperty)
+						changeListener->onPropertyChanged(*this, *dirtyProperty->m_pd, dirtyProperty->m_valuePtr);
 				}
+
+				if (ignoreDuplicateCalls)
+					emitEliminateDuplicates();
+				else
+					emitWithDuplicates();
+			//a proxy property of this container whose inputs were changed by the emitted signals is emitted right away
+			} while (runEmitRequests());
+
+			//TODO: check if we need to support duplicate signal resolving for removed properties
+			//indexed on purpose, a slot might remove another property
+			for (size_t i = 0; i < m_removedProperties.size(); ++i)
+			{
+				for (size_t j = 0; j < m_removedProperties[i].m_connectedSignals.size(); ++j)
+				{
+					auto [container, dirtySignal] = m_removedProperties[i].m_connectedSignals[j];
+					dirtySignal->emit(container, m_removedProperties[i].m_valuePtr);
+				}
+			}
+			m_removedProperties.clear();
+		}
+		//returns false if no proxy property requested onEmit
+		bool runEmitRequests()
+		{
+			if (m_emitRequests.empty())
+				return false;
+			//indexed on purpose, a proxy property might request another onEmit
+			for (size_t i = 0; i < m_emitRequests.size(); ++i)
+			{
+				auto* proxyProperty = m_emitRequests[i];
+				proxyProperty->m_isEmitRequested = false;
+				proxyProperty->onEmit();
+			}
+			m_emitRequests.clear();
+			return true;
+		}
+		void emitEliminateDuplicates()
+		{
+			//a slot emitting this container again can't reuse the scratch buffers
+			if (m_isEmitting)
+			{
+				InvocationSet alreadyInvokedSlots;
+				std::vector<PropertyData*> changedProperties;
+				changedProperties.swap(m_changedProperties);
+				emitChangedProperties(changedProperties, &alreadyInvokedSlots);
+				return;
 			}
+			m_isEmitting = true;
+			m_invokedSlots.clear();
+			//the changed properties are swapped out, because changing a property could result in the change of another property
+			m_emittingProperties.swap(m_changedProperties);
+			emitChangedProperties(m_emittingProperties, &m_invokedSlots);
+			m_emittingProperties.clear();
+			m_isEmitting = false;
 		}
 		void emitWithDuplicates()
 		{
-			//here we make a local copy, because changing a property could result in the change of another property
-			auto changedProperties = m_changedProperties;
-			m_changedProperties.clear();
+			if (m_isEmitting)
+			{
+				std::vector<PropertyData*> changedProperties;
+				changedProperties.swap(m_changedProperties);
+				emitChangedProperties(changedProperties, nullptr);
+				return;
+			}
+			m_isEmitting = true;
+			m_emittingProperties.swap(m_changedProperties);
+			emitChangedProperties(m_emittingProperties, nullptr);
+			m_emittingProperties.clear();
+			m_isEmitting = false;
+		}
+		static void emitChangedProperties(const std::vector<PropertyData*>& changedProperties, InvocationSet* alreadyInvokedSlots)
+		{
 			for (auto* dirtyProperty : changedProperties)
 			{
 				const void* newValue = dirtyProperty->m_valuePtr;
-				for (auto& dirtySignal : dirtyProperty->m_connectedSignals)
-					dirtySignal->emit(this, newValue);
+				//indexed on purpose, a slot might connect to the same PD and grow the vector
+				const auto& connectedSignals = dirtyProperty->m_connectedSignals;
+				for (size_t i = 0; i < connectedSignals.size(); ++i)
+				{
+					const auto [container, dirtySignal] = connectedSignals[i];
+					if (alreadyInvokedSlots)
+						dirtySignal->emitUnique(container, newValue, *alreadyInvokedSlots);
+					else
+						dirtySignal->emit(container, newValue);
+				}
 			}
 		}
 		template<typename T>
 		Property<T>* getPropertyInternal(const PropertyDescriptor<T>& pd) const
 		{
-			if (auto valueIt = m_propertyData.find(&pd); valueIt != end(m_propertyData))
+			if (auto valueIt = m_propertyData.find(&pd); valueIt != m_propertyData.end())
 			{
 				auto& propertyData = valueIt->second.m_property;
 				return static_cast<Property<T>*>(propertyData.get());
@@ -451,10 +1454,27 @@ namespace ps
 		template<typename T>
 		Property<T>& getOrConstructPropertyInternal(const PropertyDescriptor<T>& pd)
 		{
-			auto& propertyData = m_propertyData[&pd];;
+			auto& propertyData = m_propertyData[&pd];
+			if constexpr (std::is_copy_constructible_v<T>)
+			{
+				if (propertyData.m_property && propertyData.isCopyOnWrite())
+				{
+					//the property is shared with a copy of this container, so this container gets its own copy before it's changed
+					auto sharedProperty = std::static_pointer_cast<Property<T>>(std::move(propertyData.m_property));
+					auto property = allocateSharedInternal<Property<T>>(sharedProperty->get());
+					property->setChangePolicy(pd.getChangePolicy());
+					propertyData.init(std::move(property), this, &pd);
+				}
+			}
 			if (!propertyData.m_property)
 			{
-				propertyData.init(std::make_shared<Property<T>>(), this, &pd);
+				std::shared_ptr<Property<T>> property;
+				if constexpr (s_isStoredInline<T>)
+					property = propertyData.template constructInlineProperty<T>(*this);
+				else
+					property = allocateSharedInternal<Property<T>>();
+				property->setChangePolicy(pd.getChangePolicy());
+				propertyData.init(std::move(property), this, &pd);
 			}
 			return static_cast<Property<T>&>(*propertyData.m_property);
 		}
@@ -477,10 +1497,18 @@ namespace ps
 			//this is the normal case where we store a value
 			if constexpr (std::is_convertible_v<std::decay_t<U>, T>)
 			{
+				const bool isOwnershipTaken = !ownsPropertyDataInternal(pd);
 				Property<T>& property = getOrConstructPropertyInternal(pd);
 				if (auto& propertydata = m_propertyData[&pd]; !propertydata.m_isProxyProperty)
 				{
 					property.set(std::forward<U>(value));
+					//a property that takes over the ownership with the value that was visible before isn't emitted,
+					//but a replica has to know which container owns it (the values of the parent might change later)
+					if (isOwnershipTaken && !propertydata.m_propertyChanged)
+					{
+						if (auto* changeListener = getChangeListenerInternal())
+							changeListener->onPropertyChanged(*this, pd, propertydata.m_valuePtr);
+					}
 				}
 				else
 				{
@@ -489,9 +1517,8 @@ namespace ps
 					//turn the proxy property into a normal property
 					//if this is really intended call remove property + setProperty instead
 					assert(false);
-					removeProxyProperty(static_cast<ProxyProperty<T>*>(&property));
-					auto& propertySharedPtr = m_propertyData[&pd].m_property;
-					propertySharedPtr.reset();
+					removeProxyProperty(pd);
+					m_propertyData[&pd].resetProperty(this);
 					auto& newProperty = getOrConstructPropertyInternal(pd);
 					newProperty.set(std::forward<U>(value));
 				}
@@ -501,10 +1528,19 @@ namespace ps
 			else if constexpr (std::is_base_of_v<ProxyProperty<T>, typename U::element_type>)
 			{
 				auto& propertyData = m_propertyData[&pd];
-				auto proxyProperty = addChildContainerInternal<typename U::element_type>(std::move(value));
+				if (propertyData.m_isStaticProperty)
+				{
+					assert(false && "a static property can't be replaced by a proxy property");
+					return;
+				}
+				//a proxy property that was set before is replaced
+				if (propertyData.m_isProxyProperty)
+					removeProxyProperty(pd);
+				auto proxyProperty = addChildContainerInternal<typename U::element_type>(toSharedInternal(std::move(value)));
 				propertyData.template init<T, typename U::element_type>(std::static_pointer_cast<Property<T>>(proxyProperty), this, &pd);
 				propertyData.m_isProxyProperty = true;
 				static_cast<PropertyContainerBase&>(*proxyProperty).m_key = &pd;
+				++m_proxyChildCount;
 				const T& newValue = proxyProperty->get();
 				if (pd.getDefaultValue() != newValue)
 				{
@@ -515,62 +1551,147 @@ namespace ps
 				static_assert(std::is_same_v<T, void>, "The type T of the property descriptor doesn't match the type of the passed value.");
 		}
 
-		void removeProxyProperty(const PropertyContainerBase* proxyProperty)
+		//proxy properties are the children that are stored via the key of the PD
+		template<typename T>
+		void removeProxyProperty(const PropertyDescriptor<T>& pd)
 		{
-			auto ppIt = std::find_if(begin(m_children), end(m_children), [proxyProperty](const std::shared_ptr<PropertyContainerBase>& childPtr)
+			//proxy properties are only available for the default PropertyContainer
+			if constexpr (std::is_base_of_v<PropertyContainerBase, ProxyProperty<T>>)
 			{
-				return childPtr.get() == proxyProperty;
-			});
-			if (ppIt != end(m_children))
-				m_children.erase(ppIt);
+				auto* property = static_cast<Property<T>*>(m_propertyData[&pd].m_property.get());
+				PropertyContainerBase& proxyProperty = *static_cast<ProxyProperty<T>*>(property);
+				auto proxyPropertyPtr = takeChildInternal(proxyProperty);
+				detachChildInternal(proxyProperty);
+			}
 		}
 
-		template<typename T>
-		void updateAllSignals(const PropertyDescriptor<T>& pd)
+		//we have to remove all the signals of the subtree from the containers above
+		//otherwise we would keep dangling pointers, afterwards they are routed within the subtree
+		void detachChildInternal(PropertyContainerBase& child)
 		{
-			auto& propertyData = m_propertyData[&pd];
-			propertyData.m_connectedSignals.clear();
-			getAllSignals(pd, propertyData.m_connectedSignals);
+			//the handles of the subtree move to the generation of the child once they resolve their properties again
+			nextGenerationInternal(true);
+			//the containers above usually store a lot more signals than the subtree has, so only the subtree is visited
+			std::vector<std::pair<KeyT, ConnectedSignal>> detachedSignals;
+			child.collectDetachedSignals(child, detachedSignals);
+			auto isDetached = [&child](const ConnectedSignal& connected) { return child.isAncestorOf(*connected.m_container); };
+			for (auto* container = this; container; container = container->m_parent)
+			{
+				for (auto& removedProperty : container->m_removedProperties)
+				{
+					auto& signals = removedProperty.m_connectedSignals;
+					signals.erase(std::remove_if(begin(signals), end(signals), isDetached), end(signals));
+				}
+			}
+			if (child.m_isEmitRequested)
+			{
+				child.m_isEmitRequested = false;
+				m_emitRequests.erase(std::find(begin(m_emitRequests), end(m_emitRequests), &child));
+			}
+			auto* previousOwner = getRegistryOwnerInternal();
+			auto* previousRoot = getRootInternal();
+			child.setParent(nullptr);
+			//the changes posted to the detached containers are applied by the next emit of the child, the rest stays pending
+			transferPostedChanges(*previousRoot, child, child);
+			transferDirtyContainers(*previousOwner, child);
+			transferPreEmitRequests(*previousRoot, child);
+			for (auto& [pd, connected] : detachedSignals)
+				connected.m_container->getSignalRoutingContainer(*pd)->addSignal(*pd, connected);
 		}
 
-		void addSignal(const PropertyDescriptorBase& pd, Signal_PMF* signal)
+		//removes the signals of this container and its children that are stored above the given subtree
+		void collectDetachedSignals(const PropertyContainerBase& subtree, std::vector<std::pair<KeyT, ConnectedSignal>>& detachedSignals)
 		{
-			auto& propertyData = m_propertyData[&pd];
-			//TODO: check if this can be optimized
-			if (std::find(begin(propertyData.m_connectedSignals), end(propertyData.m_connectedSignals), signal) == end(propertyData.m_connectedSignals))
-				propertyData.m_connectedSignals.emplace_back(signal);
+			for (auto& [pd, propertyData] : m_propertyData)
+			{
+				auto* routingContainer = getSignalRoutingContainer(*pd);
+				if (subtree.isAncestorOf(*routingContainer))
+					continue;
+				auto routingDataIt = routingContainer->m_propertyData.find(pd);
+				if (routingDataIt == routingContainer->m_propertyData.end())
+					continue;
+				auto& signals = routingDataIt->second.m_connectedSignals;
+				auto signalIt = std::find_if(begin(signals), end(signals), [&propertyData](const ConnectedSignal& connected) { return connected.m_signal == &propertyData.m_signal; });
+				if (signalIt != end(signals))
+				{
+					detachedSignals.emplace_back(pd, *signalIt);
+					signals.erase(signalIt);
+				}
+			}
+			for (auto& child : m_children)
+				child->collectDetachedSignals(subtree, detachedSignals);
 		}
 
-		void addSignals(const PropertyDescriptorBase& pd, std::vector<Signal_PMF*>& connectedSignals)
+		void addSignal(const PropertyDescriptorBase& pd, ConnectedSignal connected)
 		{
-			auto& propertyData = m_propertyData[&pd];
-			std::copy(begin(connectedSignals), end(connectedSignals), std::back_inserter(propertyData.m_connectedSignals));
+			auto& signals = m_propertyData[&pd].m_connectedSignals;
+			auto isSame = [&connected](const ConnectedSignal& other) { return other.m_signal == connected.m_signal; };
+			if (std::find_if(begin(signals), end(signals), isSame) == end(signals))
+				signals.push_back(connected);
 		}
 
-		void getAllSignals(const PropertyDescriptorBase& pd, std::vector<Signal_PMF*>& connectedSignals)
+		void commitBatch()
 		{
-			//add own subject
-			if (auto propertyDataIt = m_propertyData.find(&pd); propertyDataIt != end(m_propertyData))
-				connectedSignals.push_back(&(propertyDataIt->second.m_signal));
-
-			//add the signals of all children unless they own property data themselves
-			for (auto& children : m_children)
-				if (!children->ownsPropertyDataInternal(pd))
-					children->getAllSignals(pd, connectedSignals);
+			auto& pending = m_batchedProperties;
+			//the previous owners usually store the signals of many containers outside of this subtree, which
+			//can't be affected by the batch, whether a container is part of this subtree is only resolved once
+			std::unordered_map<const PropertyContainerBase*, bool> isInSubtree;
+			//the signals are always stored at the first container in the parent chain that owns the PD (or the root)
+			//so the properties that resolve at the current level are removed, the rest is passed on to the next level
+			for (auto* container = m_parent; container && !pending.empty(); container = container->m_parent)
+			{
+				auto keepIt = begin(pending);
+				for (auto* pd : pending)
+				{
+					if (!container->m_parent || container->ownsPropertyDataInternal(*pd))
+						container->rerouteSubtreeSignals(*pd, *this, isInSubtree);
+					else
+						*keepIt++ = pd;
+				}
+				pending.erase(keepIt, end(pending));
+			}
+			pending.clear();
 		}
 
-		void setParentContainerForProperty(const PropertyDescriptorBase& pd, PropertyContainerBase* container)
+		//same as rerouteSignals, but only the signals of the containers within the given subtree are rerouted
+		void rerouteSubtreeSignals(const PropertyDescriptorBase& pd, const PropertyContainerBase& subtree, std::unordered_map<const PropertyContainerBase*, bool>& isInSubtree)
 		{
-			if (container)
-				m_toContainer[&pd] = container;
-			else
-				m_toContainer.erase(&pd);
+			auto propertyDataIt = m_propertyData.find(&pd);
+			if (propertyDataIt == m_propertyData.end())
+				return;
+			auto& signals = propertyDataIt->second.m_connectedSignals;
+			auto keepIt = begin(signals);
+			for (auto& connected : signals)
+			{
+				auto [subtreeIt, isNew] = isInSubtree.try_emplace(connected.m_container, false);
+				if (isNew)
+					subtreeIt->second = subtree.isAncestorOf(*connected.m_container);
+				auto* container = subtreeIt->second ? connected.m_container->getSignalRoutingContainer(pd) : this;
+				if (container == this)
+					*keepIt++ = connected;
+				else
+					container->addSignal(pd, connected);
+			}
+			signals.erase(keepIt, end(signals));
+		}
 
-			for (auto& children : m_children)
+		//routes all signals of the given PD that no longer resolve to this container
+		//to the container they resolve to now, this is called after the ownership of the PD changed
+		void rerouteSignals(const PropertyDescriptorBase& pd)
+		{
+			auto propertyDataIt = m_propertyData.find(&pd);
+			if (propertyDataIt == m_propertyData.end())
+				return;
+			auto& signals = propertyDataIt->second.m_connectedSignals;
+			auto keepIt = begin(signals);
+			for (auto& connected : signals)
 			{
-				if (!children->ownsPropertyDataInternal(pd))
-					children->setParentContainerForProperty(pd, container);
+				if (auto* container = connected.m_container->getSignalRoutingContainer(pd); container == this)
+					*keepIt++ = connected;
+				else
+					container->addSignal(pd, connected);
 			}
+			signals.erase(keepIt, end(signals));
 		}
 
 		template<typename T>
@@ -579,18 +1700,29 @@ namespace ps
 			auto& propertyData = m_propertyData[&pd];
 			if (!propertyData.m_property)
 				return;
+			if (propertyData.m_isStaticProperty)
+			{
+				assert(false && "a static property can't be removed");
+				return;
+			}
+			if (auto* changeListener = getChangeListenerInternal(); changeListener && !propertyData.m_isProxyProperty)
+				changeListener->onPropertyRemoved(*this, pd);
 			//copy the old signal ptr
 			auto oldSignals = propertyData.m_connectedSignals;
 			auto* propertyPtr = propertyData.m_property.get();
 			auto oldValue = static_cast<Property<T>*>(propertyPtr)->get();
-			//we have to update all children and tell it which is the correct owning property container
+			//the children will now resolve the property via the parent chain
 			auto newContainer = m_parent ? m_parent->getOwningPropertyContainer(pd) : nullptr;
-			setParentContainerForProperty(pd, newContainer);
-			//we have to add all the signals from this level to the new owning container
+			//we have to add all the signals from this level to the new owning container (or the root)
+			if (m_parent)
+			{
+				auto* routingContainer = m_parent->getSignalRoutingContainer(pd);
+				for (auto& connected : oldSignals)
+					routingContainer->addSignal(pd, connected);
+				propertyData.m_connectedSignals.clear();
+			}
 			if (newContainer)
 			{
-				newContainer->addSignals(pd, oldSignals);
-
 				Property<T>* newValue = newContainer->getPropertyInternal(pd);
 				if (newValue->get() != oldValue)
 				{
@@ -602,29 +1734,23 @@ namespace ps
 			{
 				//there are still observers, but no new container
 				//we need to signal the default value to the observers
-                auto& removedProperty = m_removedProperties.emplace_back(std::make_unique<PropertyData>());
-                removedProperty->m_property = std::make_shared<Property<T>>(pd.getDefaultValue());
-                removedProperty->m_valuePtr = &(std::static_pointer_cast<Property<T>>(removedProperty->m_property)->get());
-                removedProperty->m_connectedSignals = std::move(oldSignals);
+				auto& removedProperty = m_removedProperties.emplace_back();
+				removedProperty.m_property = allocateSharedInternal<Property<T>>(pd.getDefaultValue());
+				removedProperty.m_valuePtr = &(std::static_pointer_cast<Property<T>>(removedProperty.m_property)->get());
+				removedProperty.m_connectedSignals = std::move(oldSignals);
+				enqueueDirtyContainer();
 			}
 			//now we remove the property data
 			if (propertyData.m_isProxyProperty)
-				removeProxyProperty(static_cast<ProxyProperty<T>*>(propertyPtr));
+				removeProxyProperty(pd);
 			
-			propertyData.m_property = nullptr;
-		}
-
-		template<typename T>
-		void observePropertyInternal(const PropertyDescriptor<T>& pd, std::vector<std::function<void()>>* observers)
-		{
-			auto& propertyData = m_propertyData[&pd];
-			propertyData.push_back(observers);
+			propertyData.resetProperty(this);
 		}
 
 		bool ownsPropertyDataInternal(const PropertyDescriptorBase& pd) const noexcept
 		{
 			auto it = m_propertyData.find(&pd);
-			return  it != end(m_propertyData) && it->second.m_property;
+			return  it != m_propertyData.end() && it->second.m_property;
 		}
 
 		template<typename T>
@@ -640,17 +1766,222 @@ namespace ps
 			{
 				propertyData.m_propertyChanged = true;
 				m_changedProperties.emplace_back(&propertyData);
+				enqueueDirtyContainer();
+			}
+		}
+
+		//registers this container once at its registry owner, so the next emit visits it
+		void enqueueDirtyContainer()
+		{
+			if (m_isQueued)
+				return;
+			m_isQueued = true;
+			uint32_t depth = 0;
+			auto* owner = getRegistryOwnerInternal(&depth);
+			owner->m_dirtyContainers.push_back({ this, depth });
+			owner->enqueueDirtySubtree();
+		}
+
+		//registers an independent subtree with pending changes at the registry owner above
+		//while the subtree is emitted it is registered again once its emit is done (see drainDirtyContainers)
+		void enqueueDirtySubtree()
+		{
+			if (!m_parent || m_isSubtreeQueued || m_isDraining)
+				return;
+			m_isSubtreeQueued = true;
+			uint32_t depth = 0;
+			auto* owner = m_parent->getRegistryOwnerInternal(&depth);
+			owner->m_dirtyContainers.push_back({ this, depth + 1 });
+			owner->enqueueDirtySubtree();
+		}
+
+		//moves the dirty containers of the given subtree from the registry of 'from' to their current
+		//registry owner, this is needed whenever the subtree is attached, detached or becomes (in)dependent
+		static void transferDirtyContainers(PropertyContainerBase& from, PropertyContainerBase& subtree)
+		{
+			std::vector<PropertyContainerBase*> moved;
+			auto isMoved = [&subtree, &moved](const DirtyContainer& dirty) {
+				if (!dirty.m_container || !subtree.isAncestorOf(*dirty.m_container))
+					return false;
+				moved.push_back(dirty.m_container);
+				return true;
+			};
+			auto& registry = from.m_dirtyContainers;
+			registry.erase(std::remove_if(begin(registry), end(registry), isMoved), end(registry));
+			//containers of a running emit that weren't processed yet keep their changes
+			for (auto& dirty : from.m_emittingContainers)
+			{
+				if (isMoved(dirty))
+					dirty.m_container = nullptr;
+			}
+			for (auto*& independentSubtree : from.m_emittingSubtrees)
+			{
+				if (independentSubtree && subtree.isAncestorOf(*independentSubtree))
+				{
+					moved.push_back(independentSubtree);
+					independentSubtree = nullptr;
+				}
+			}
+			for (auto* container : moved)
+			{
+				if (container != &from && container->m_isIndependentSubtree && container->m_isSubtreeQueued)
+				{
+					container->m_isSubtreeQueued = false;
+					container->enqueueDirtySubtree();
+				}
+				else
+				{
+					container->m_isQueued = false;
+					container->enqueueDirtyContainer();
+				}
+			}
+		}
+
+		//applies all the changes that were posted so far, in the order they were posted
+		void applyPostedChanges()
+		{
+			//a change applied by a running call can't apply the remaining changes again
+			if (!m_applyingChanges.empty())
+				return;
+			deferPostedChanges();
+			if (m_deferredChanges.empty())
+				return;
+			//the changes are swapped out, applying a change might detach containers (see transferPostedChanges)
+			m_applyingChanges.swap(m_deferredChanges);
+			//starting with the most recent change, the first change per container and PD is the one that wins
+			m_appliedChanges.clear();
+			for (auto it = m_applyingChanges.rbegin(); it != m_applyingChanges.rend(); ++it)
+				(*it)->m_isSuperseded = !m_appliedChanges.insert((*it)->m_container, (*it)->m_pd->getId());
+			for (auto* postedChange : m_applyingChanges)
+			{
+				if (!postedChange->m_isSuperseded)
+					postedChange->apply();
+				delete postedChange;
+			}
+			m_applyingChanges.clear();
+		}
+
+		//moves the changes of the posting stack to the deferred changes, so they can be filtered and reordered
+		void deferPostedChanges()
+		{
+			const auto first = m_deferredChanges.size();
+			//the stack returns the most recent change first
+			for (auto* postedChange = m_postedChanges.takeAll(); postedChange; postedChange = postedChange->m_next)
+				m_deferredChanges.push_back(postedChange);
+			std::reverse(begin(m_deferredChanges) + static_cast<std::ptrdiff_t>(first), end(m_deferredChanges));
+		}
+
+		//moves the pending posted changes of the given subtree from the root 'from' to the root 'to'
+		static void transferPostedChanges(PropertyContainerBase& from, PropertyContainerBase& to, const PropertyContainerBase& subtree)
+		{
+			from.deferPostedChanges();
+			to.deferPostedChanges();
+			auto& changes = from.m_deferredChanges;
+			auto keepIt = begin(changes);
+			for (auto* postedChange : changes)
+			{
+				if (subtree.isAncestorOf(*postedChange->m_container))
+					to.m_deferredChanges.push_back(postedChange);
+				else
+					*keepIt++ = postedChange;
+			}
+			changes.erase(keepIt, end(changes));
+		}
+
+		void nextGenerationInternal(bool isStructureChange = false) noexcept
+		{
+			if (auto& generation = getRootInternal()->m_generation)
+			{
+				generation->m_value.fetch_add(1, std::memory_order_relaxed);
+				if (isStructureChange)
+					generation->m_structure.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		PropertyContainerBase* getRootInternal() noexcept
+		{
+			auto* container = this;
+			while (container->m_parent)
+				container = container->m_parent;
+			return container;
+		}
+
+		//using the value type with a container makes its properties settable by name
+		template<typename T>
+		static void bindPropertyInputInternal() noexcept
+		{
+			if constexpr (has_property_parser_v<T> && std::is_default_constructible_v<T>)
+				(void)PropertyInputBinder<T>::s_isBound;
+		}
+
+		//the properties of proxy property containers are the inputs of the proxy, they aren't reported
+		ChangeListener* getChangeListenerInternal() noexcept
+		{
+			if (isProxyProperty())
+				return nullptr;
+			auto* root = getReportingRootInternal();
+			return root ? root->m_changeListener : nullptr;
+		}
+
+		//the root of the hierarchy this container is reported to, nullptr for (the subtree of) a copy, which
+		//still sees the parent of the original until it's added somewhere, but isn't one of its children
+		PropertyContainerBase* getReportingRootInternal() noexcept
+		{
+			auto* container = this;
+			for (; container->m_parent; container = container->m_parent)
+			{
+				const auto& siblings = container->m_parent->m_children;
+				if (container->m_indexInParent >= siblings.size() || siblings[container->m_indexInParent].get() != container)
+					return nullptr;
 			}
+			return container;
 		}
 
-		PropertyContainerBase* getOwningPropertyContainer(const PropertyDescriptorBase& pd)
+		//the registry owner is the first container in the parent chain that is
+		//either the head of an independent subtree or the root
+		PropertyContainerBase* getRegistryOwnerInternal(uint32_t* depth = nullptr) noexcept
 		{
-			//check if we own the property ourselves
-			if (ownsPropertyDataInternal(pd))
-				return this;
-			//check if we know any container that owns the given PD
-			auto containerIt = m_toContainer.find(&pd);
-			return containerIt != end(m_toContainer) ? (containerIt->second) : nullptr;
+			auto* container = this;
+			uint32_t level = 0;
+			for (; container->m_parent && !container->m_isIndependentSubtree; container = container->m_parent)
+				++level;
+			if (depth)
+				*depth = level;
+			return container;
+		}
+
+		//the owner is the first container in the parent chain that has the property set
+		PropertyContainerBase* getOwningPropertyContainer(const PropertyDescriptorBase& pd) const noexcept
+		{
+			for (auto* container = this; container; container = container->m_parent)
+			{
+				if (container->ownsPropertyDataInternal(pd))
+					return const_cast<PropertyContainerBase*>(container);
+			}
+			return nullptr;
+		}
+
+		//the signals of a PD are stored at the owning container
+		//if nobody owns the PD they are stored at the root, so they can be found if the PD gets set
+		PropertyContainerBase* getSignalRoutingContainer(const PropertyDescriptorBase& pd) noexcept
+		{
+			auto* container = this;
+			for (; container->m_parent; container = container->m_parent)
+			{
+				if (container->ownsPropertyDataInternal(pd))
+					return container;
+			}
+			return container;
+		}
+
+		bool isAncestorOf(const PropertyContainerBase& other) const noexcept
+		{
+			for (auto* container = &other; container; container = container->m_parent)
+			{
+				if (container == this)
+					return true;
+			}
+			return false;
 		}
 
 		void setParent(PropertyContainerBase* container)
@@ -1,4 +1,5 @@
 #pragma once
+#include <memory>
 #include <utility>
 #include <type_traits>
 #include "PropertyDescriptorBase.h"
@@ -11,10 +12,19 @@ namespace ps
 	//#
 	//############################################################################
 
+	//parses an input and sets it as the value of a PD of the value type T in a container (see setPropertyByName)
+	//the setter is bound by the container code (see PropertyInputBinder), so this header doesn't depend on the container
+	template<typename T>
+	struct PropertyInputSetter
+	{
+		static inline PropertyDescriptorBase::SetFromInputFn s_setFromInput = nullptr;
+	};
+
 	template<typename T>
 	class PropertyDescriptor : public PropertyDescriptorBase
 	{
 	private:
+		const std::unique_ptr<const ChangePolicy<T>> m_changePolicy;
 		const Property<T> m_defaultValue;
 	public:
 		using value_type = T;
@@ -25,6 +35,16 @@ namespace ps
 			if constexpr (std::is_reference_v<T>)
 				static_assert("Please use std::reference wrapper for using reference semantics.\n"
 					"The underlying storage doesn't support references");
+			m_setFromInput = &PropertyInputSetter<T>::s_setFromInput;
+		}
+		//all the properties of this PD use the change policy to decide if a new value is a change
+		template<typename PolicyT, typename = std::enable_if_t<std::is_base_of_v<ChangePolicy<T>, std::decay_t<PolicyT>>>>
+		PropertyDescriptor(T&& defaultValue, PolicyT&& changePolicy, std::string identifier = "")
+			: PropertyDescriptorBase(std::move(identifier))
+			, m_changePolicy(std::make_unique<std::decay_t<PolicyT>>(std::forward<PolicyT>(changePolicy)))
+			, m_defaultValue(makeDefaultValueInternal(std::forward<T>(defaultValue), m_changePolicy.get()))
+		{
+			m_setFromInput = &PropertyInputSetter<T>::s_setFromInput;
 		}
 
 		PropertyDescriptor(const PropertyDescriptor&) = delete;
@@ -36,5 +56,17 @@ namespace ps
 		{
 			return m_defaultValue;
 		}
+
+		const ChangePolicy<T>* getChangePolicy() const noexcept
+		{
+			return m_changePolicy.get();
+		}
+	private:
+		static Property<T> makeDefaultValueInternal(T&& defaultValue, const ChangePolicy<T>* changePolicy)
+		{
+			Property<T> property(std::forward<T>(defaultValue));
+			property.setChangePolicy(changePolicy);
+			return property;
+		}
 	};
 }
@@ -1,4 +1,9 @@
 #pragma once
+#include "PropertySystem_forward.h"
+#include "PropertyDescriptorRegistry.h"
+#include "PropertyParser.h"
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 namespace ps
@@ -13,16 +18,39 @@ namespace ps
 	//right now the primary lookup of a PD is via it's const ref
 	//other implementation use a string type, but I think having to use a descriptor
 	//directly makes everything a bit more comfortable and the lookup is faster
+	//every PD additionally gets a dense sequential id, which allows the containers
+	//to store their data in flat arrays that are indexed by that id (see DenseMap)
+	//PDs with a name can also be found by it via the PropertyDescriptorRegistry
 
 	class PropertyDescriptorBase
 	{
 	protected:
 		const std::string m_name;
+		const uint32_t m_id;
+	public:
+		using SetFromInputFn = bool(*)(PropertyContainer&, const PropertyDescriptorBase&, const PropertyInput&);
+	protected:
+		//set by PropertyDescriptor<T>, it points to the setter of the value type (see PropertyInputSetter)
+		const SetFromInputFn* m_setFromInput = nullptr;
+
+		static uint32_t nextId() noexcept
+		{
+			static std::atomic<uint32_t> s_nextId{ 0 };
+			return s_nextId.fetch_add(1, std::memory_order_relaxed);
+		}
 	public:
 		template<typename T>
 		PropertyDescriptorBase(T&& name = std::string())
 			: m_name(std::forward<T>(name))
+			, m_id(nextId())
+		{
+			if (!m_name.empty())
+				PropertyDescriptorRegistry::global().add(m_name, *this);
+		}
+		~PropertyDescriptorBase()
 		{
+			if (!m_name.empty())
+				PropertyDescriptorRegistry::global().remove(m_name, *this);
 		}
 
 		PropertyDescriptorBase(const PropertyDescriptorBase&) = delete;
@@ -34,5 +62,17 @@ namespace ps
 		{
 			return m_name;
 		}
+
+		uint32_t getId() const noexcept
+		{
+			return m_id;
+		}
+
+		//converts the input to the value type of this PD and sets it in the container,
+		//returns false if the input can't be converted or the value type has no PropertyParser
+		bool setPropertyFromInput(PropertyContainer& container, const PropertyInput& input) const
+		{
+			return m_setFromInput && *m_setFromInput && (*m_setFromInput)(container, *this, input);
+		}
 	};
 }
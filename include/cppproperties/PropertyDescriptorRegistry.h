@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ps
+{
+	class PropertyDescriptorBase;
+
+	//###########################################################################
+	//#
+	//#                        PropertyDescriptorRegistry
+	//#
+	//############################################################################
+
+	//finds PDs by their name, e.g. to set properties from a config file (see PropertyContainer::setPropertyByName)
+	//every PD with a name adds itself to the global registry when it's constructed and removes itself when it's destroyed,
+	//other registries only contain the PDs that were added explicitly
+	//if several PDs have the same name, the one that was added first is found, the others are kept in order and
+	//the next one is found once it's removed
+	//freeze builds a perfect hash table of the PDs added so far (hash and displace), so a lookup is one hash of the name,
+	//two table loads and one string comparison without taking the lock, PDs that are added afterwards are still found
+	//via the hash map, removing a PD unfreezes the registry again
+	class PropertyDescriptorRegistry
+	{
+		struct Slot
+		{
+			std::string_view m_name;
+			const PropertyDescriptorBase* m_pd = nullptr;
+		};
+
+		std::unordered_map<std::string_view, const PropertyDescriptorBase*> m_descriptors;
+		//the PDs whose name is already used by a PD in m_descriptors, in the order they were added
+		std::vector<Slot> m_shadowed;
+		//the perfect hash table, see freeze, it's only written by freeze
+		std::vector<uint32_t> m_seeds;
+		std::vector<Slot> m_slots;
+		std::atomic<bool> m_isFrozen = false;
+		std::atomic<bool> m_hasAddedAfterFreeze = false;
+		mutable std::shared_mutex m_mutex;
+
+		static uint64_t mix(uint64_t hash) noexcept
+		{
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdull;
+			hash ^= hash >> 33;
+			return hash;
+		}
+		//hashes the name 8 bytes at a time
+		static uint64_t hashName(std::string_view name) noexcept
+		{
+			uint64_t hash = 0x9E3779B97F4A7C15ull ^ name.size();
+			const char* data = name.data();
+			size_t size = name.size();
+			for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t))
+			{
+				uint64_t word;
+				std::memcpy(&word, data, sizeof(uint64_t));
+				hash = (hash ^ word) * 0xc4ceb9fe1a85ec53ull;
+				hash ^= hash >> 29;
+			}
+			//a memcpy with a variable size would be a library call
+			uint64_t tail = 0;
+			for (size_t i = 0; i < size; ++i)
+				tail |= uint64_t(static_cast<unsigned char>(data[i])) << (8 * i);
+			return mix(hash ^ tail);
+		}
+		//both table sizes are powers of two, so the bucket and the slot are masked out of the hash
+		static size_t bucketOf(uint64_t hash, size_t bucketCount) noexcept
+		{
+			return static_cast<size_t>(hash >> 32) & (bucketCount - 1);
+		}
+		static size_t slotOf(uint64_t hash, uint32_t seed, size_t slotCount) noexcept
+		{
+			return static_cast<size_t>(mix(hash ^ (seed * 0x9E3779B97F4A7C15ull))) & (slotCount - 1);
+		}
+		static size_t nextPowerOfTwo(size_t value) noexcept
+		{
+			size_t result = 1;
+			while (result < value)
+				result <<= 1;
+			return result;
+		}
+
+		const PropertyDescriptorBase* findFrozen(std::string_view name) const noexcept
+		{
+			const uint64_t hash = hashName(name);
+			const uint32_t seed = m_seeds[bucketOf(hash, m_seeds.size())];
+			const Slot& slot = m_slots[slotOf(hash, seed, m_slots.size())];
+			return slot.m_pd && slot.m_name == name ? slot.m_pd : nullptr;
+		}
+
+		//places the keys bucket by bucket (largest first), each bucket gets the first seed that maps its keys to free slots
+		bool buildPerfectHash()
+		{
+			const size_t count = m_descriptors.size();
+			const size_t bucketCount = nextPowerOfTwo(count / 4 + 1);
+			const size_t slotCount = nextPowerOfTwo(count + count / 4 + 1);
+			std::vector<std::vector<std::pair<uint64_t, Slot>>> buckets(bucketCount);
+			for (const auto& [name, pd] : m_descriptors)
+			{
+				const uint64_t hash = hashName(name);
+				buckets[bucketOf(hash, bucketCount)].push_back({ hash, { name, pd } });
+			}
+			std::vector<size_t> order(bucketCount);
+			for (size_t i = 0; i < bucketCount; ++i)
+				order[i] = i;
+			std::sort(order.begin(), order.end(), [&buckets](size_t lhs, size_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+			std::vector<uint32_t> seeds(bucketCount, 0);
+			std::vector<Slot> slots(slotCount);
+			std::vector<size_t> placed;
+			for (const size_t bucket : order)
+			{
+				if (buckets[bucket].empty())
+					break;
+				bool isPlaced = false;
+				for (uint32_t seed = 0; seed < (1u << 20) && !isPlaced; ++seed)
+				{
+					placed.clear();
+					isPlaced = true;
+					for (const auto& [hash, slot] : buckets[bucket])
+					{
+						const size_t index = slotOf(hash, seed, slotCount);
+						if (slots[index].m_pd)
+						{
+							isPlaced = false;
+							break;
+						}
+						slots[index] = slot;
+						placed.push_back(index);
+					}
+					if (!isPlaced)
+					{
+						for (const size_t index : placed)
+							slots[index] = Slot{};
+					}
+					else
+						seeds[bucket] = seed;
+				}
+				//only happens if two names have the same 64 bit hash
+				if (!isPlaced)
+					return false;
+			}
+			m_seeds = std::move(seeds);
+			m_slots = std::move(slots);
+			return true;
+		}
+
+	public:
+		PropertyDescriptorRegistry() = default;
+		PropertyDescriptorRegistry(const PropertyDescriptorRegistry&) = delete;
+		PropertyDescriptorRegistry& operator=(const PropertyDescriptorRegistry&) = delete;
+
+		//the registry all named PDs are added to
+		static PropertyDescriptorRegistry& global()
+		{
+			static PropertyDescriptorRegistry s_registry;
+			return s_registry;
+		}
+
+		//the name has to stay valid as long as the PD is part of the registry
+		void add(std::string_view name, const PropertyDescriptorBase& pd)
+		{
+			std::unique_lock lock(m_mutex);
+			if (!m_descriptors.emplace(name, &pd).second)
+				m_shadowed.push_back({ name, &pd });
+			else if (m_isFrozen.load(std::memory_order_relaxed))
+				m_hasAddedAfterFreeze.store(true, std::memory_order_release);
+		}
+
+		void remove(std::string_view name, const PropertyDescriptorBase& pd)
+		{
+			std::unique_lock lock(m_mutex);
+			auto it = m_descriptors.find(name);
+			if (it == m_descriptors.end())
+				return;
+			if (it->second != &pd)
+			{
+				auto shadowed = std::find_if(m_shadowed.begin(), m_shadowed.end(), [&](const Slot& slot) { return slot.m_pd == &pd; });
+				if (shadowed != m_shadowed.end())
+					m_shadowed.erase(shadowed);
+				return;
+			}
+			m_descriptors.erase(it);
+			//the key is the name of the removed PD, so the next PD with this name is added with its own name
+			auto next = std::find_if(m_shadowed.begin(), m_shadowed.end(), [&](const Slot& slot) { return slot.m_name == name; });
+			if (next != m_shadowed.end())
+			{
+				m_descriptors.emplace(next->m_name, next->m_pd);
+				m_shadowed.erase(next);
+			}
+			m_isFrozen.store(false, std::memory_order_release);
+		}
+
+		//returns nullptr if there is no PD with this name
+		[[nodiscard]] const PropertyDescriptorBase* find(std::string_view name) const
+		{
+			if (m_isFrozen.load(std::memory_order_acquire))
+			{
+				if (const auto* pd = findFrozen(name); pd || !m_hasAddedAfterFreeze.load(std::memory_order_acquire))
+					return pd;
+			}
+			std::shared_lock lock(m_mutex);
+			auto it = m_descriptors.find(name);
+			return it != m_descriptors.end() ? it->second : nullptr;
+		}
+
+		//builds the perfect hash table for the PDs that are registered at this point, call it once they are all constructed
+		//(e.g. at the start of main), returns false if no table could be built (the lookup still works then)
+		//the table is read without the lock, so freeze must not be called while other threads look up names
+		bool freeze()
+		{
+			std::unique_lock lock(m_mutex);
+			m_isFrozen.store(false, std::memory_order_relaxed);
+			if (!buildPerfectHash())
+				return false;
+			m_hasAddedAfterFreeze.store(false, std::memory_order_relaxed);
+			m_isFrozen.store(true, std::memory_order_release);
+			return true;
+		}
+
+		[[nodiscard]] bool isFrozen() const noexcept
+		{
+			return m_isFrozen.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] size_t size() const
+		{
+			std::shared_lock lock(m_mutex);
+			return m_descriptors.size();
+		}
+	};
+}
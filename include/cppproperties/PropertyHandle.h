@@ -0,0 +1,80 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        PropertyHandle
+	//#
+	//############################################################################
+
+	//caches the property a container resolves a PD to, see PropertyContainer::handle
+	//getProperty looks up the owning container and the property data on every call,
+	//the handle only does that again if the generation of the hierarchy has changed since
+	//the generation changes if a property of the hierarchy is set for the first time or removed or if the hierarchy changes,
+	//changing the value of a property or changes in other hierarchies don't invalidate the handle
+	//the container has to outlive the handle
+	template<typename T, typename ContainerT>
+	class PropertyHandle
+	{
+		using GenerationT = typename std::pointer_traits<decltype(std::declval<const ContainerT&>().getHierarchyGeneration())>::element_type;
+
+		const ContainerT* m_container = nullptr;
+		const PropertyDescriptor<T>* m_pd = nullptr;
+		mutable const Property<T>* m_property = nullptr;
+		//the generation of the root the container belonged to when the property was resolved
+		mutable std::shared_ptr<GenerationT> m_hierarchyGeneration;
+		mutable uint64_t m_generation = 0;
+
+		void resolve() const
+		{
+			m_hierarchyGeneration = m_container->getHierarchyGeneration();
+			m_generation = m_hierarchyGeneration->m_value.load(std::memory_order_relaxed);
+			m_property = &m_container->getProperty(*m_pd);
+		}
+	public:
+		PropertyHandle() = default;
+		PropertyHandle(const ContainerT& container, const PropertyDescriptor<T>& pd)
+			: m_container(&container)
+			, m_pd(&pd)
+		{
+			resolve();
+		}
+
+		[[nodiscard]] const Property<T>& getProperty() const
+		{
+			assert(m_container && "the handle isn't bound to a container");
+			if (m_generation != m_hierarchyGeneration->m_value.load(std::memory_order_relaxed))
+				resolve();
+			return *m_property;
+		}
+
+		[[nodiscard]] const T& get() const
+		{
+			return getProperty().get();
+		}
+
+		[[nodiscard]] const T& operator()() const
+		{
+			return get();
+		}
+
+		[[nodiscard]] const PropertyDescriptor<T>& getPropertyDescriptor() const noexcept
+		{
+			return *m_pd;
+		}
+
+		[[nodiscard]] explicit operator bool() const noexcept
+		{
+			return m_container != nullptr;
+		}
+	};
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+#include "PropertyDescriptorRegistry.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        PropertyIngestor
+	//#
+	//############################################################################
+
+	//applies a stream of updates (e.g. a replay log or the output of another tool) to a hierarchy
+	//every line of the stream is one record: <path> <name> <value>
+	//	/ physics.gravity 9.81
+	//	/0/2 title hello world
+	//the path is the index of the child at every level starting from the root (proxy properties don't count),
+	//the name is looked up in the registry and the rest of the line is parsed as the value (see setPropertyByName)
+	//empty lines and lines that start with # are ignored, records that can't be applied are counted as rejected
+	//the container and PD of a path and name are only looked up the first time they appear in the stream, at most
+	//maxCacheSize of them are cached (the cache is cleared once it's full), the cache is also cleared whenever
+	//the structure of the hierarchy has changed (see PropertyContainer::getStructureGeneration)
+	//the records are set in batches (see PropertyContainer::batch), the root emits after every batch
+	//the batches are closed at the end of every feed, so the hierarchy can be restructured between the calls
+	class PropertyIngestor
+	{
+		struct ContainerEntry
+		{
+			PropertyContainer* m_container = nullptr;
+			//the number of the batch that was last opened on this container
+			uint64_t m_batchNumber = 0;
+		};
+		struct Target
+		{
+			ContainerEntry* m_entry = nullptr;
+			const PropertyDescriptorBase* m_pd = nullptr;
+		};
+
+		using StructureGenerationT = decltype(std::declval<const PropertyContainer&>().getHierarchyGeneration());
+
+		PropertyContainer& m_root;
+		const PropertyDescriptorRegistry& m_registry;
+		const size_t m_batchSize;
+		size_t m_maxCacheSize = 4096;
+		//the cache is valid as long as the root is part of the same hierarchy and it wasn't restructured
+		StructureGenerationT m_cacheGeneration;
+		uint64_t m_cacheStructure = 0;
+		std::unordered_map<std::string, ContainerEntry> m_containers;
+		//owns the keys of m_targets ("<path> <name>")
+		std::deque<std::string> m_targetKeys;
+		std::unordered_map<std::string_view, Target> m_targets;
+		std::vector<PropertyContainer::Batch> m_batches;
+		uint64_t m_batchNumber = 1;
+		size_t m_pendingCount = 0;
+		size_t m_appliedCount = 0;
+		size_t m_rejectedCount = 0;
+		//the beginning of a record that continues in the next chunk
+		std::string m_partialRecord;
+
+	public:
+		explicit PropertyIngestor(PropertyContainer& root, size_t batchSize = 4096,
+			const PropertyDescriptorRegistry& registry = PropertyDescriptorRegistry::global())
+			: m_root(root)
+			, m_registry(registry)
+			, m_batchSize(batchSize ? batchSize : 1)
+		{
+			validateCacheInternal();
+		}
+
+		PropertyIngestor(const PropertyIngestor&) = delete;
+		PropertyIngestor& operator=(const PropertyIngestor&) = delete;
+
+		//applies all complete records of the chunk, a record can be split over several chunks
+		void feed(const char* data, size_t size)
+		{
+			validateCacheInternal();
+			std::string_view chunk(data, size);
+			if (!m_partialRecord.empty())
+			{
+				const size_t end = chunk.find('\n');
+				if (end == std::string_view::npos)
+				{
+					m_partialRecord.append(chunk);
+					return;
+				}
+				m_partialRecord.append(chunk.substr(0, end));
+				applyRecordInternal(m_partialRecord);
+				m_partialRecord.clear();
+				chunk.remove_prefix(end + 1);
+			}
+			for (size_t end = chunk.find('\n'); end != std::string_view::npos; end = chunk.find('\n'))
+			{
+				applyRecordInternal(chunk.substr(0, end));
+				chunk.remove_prefix(end + 1);
+			}
+			m_partialRecord.assign(chunk);
+			//the changes of the open batch are still emitted together, but the signals are routed now
+			closeBatchesInternal();
+		}
+
+		//applies the last record if it doesn't end with a new line and emits the pending changes
+		void finish()
+		{
+			validateCacheInternal();
+			if (!m_partialRecord.empty())
+			{
+				applyRecordInternal(m_partialRecord);
+				m_partialRecord.clear();
+			}
+			flush();
+		}
+
+		//reads the file descriptor (a file, a pipe, stdin, ...) until it's closed and applies all records
+		//only bufferSize bytes (plus the longest record and the cache, see setMaxCacheSize) are held in memory at any time
+		void ingestFd(int fd, size_t bufferSize = 1 << 16)
+		{
+			std::vector<char> buffer(bufferSize);
+			while (true)
+			{
+#ifdef _WIN32
+				const auto readSize = ::_read(fd, buffer.data(), static_cast<unsigned>(buffer.size()));
+#else
+				const auto readSize = ::read(fd, buffer.data(), buffer.size());
+#endif
+				if (readSize < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					throw std::runtime_error("PropertyIngestor: can't read from the file descriptor");
+				}
+				if (readSize == 0)
+					break;
+				feed(buffer.data(), static_cast<size_t>(readSize));
+			}
+			finish();
+		}
+
+		void ingestFile(const std::string& path, size_t bufferSize = 1 << 16)
+		{
+#ifdef _WIN32
+			const int fd = ::_open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+#endif
+			if (fd < 0)
+				throw std::runtime_error("PropertyIngestor: can't open " + path);
+			struct FdCloser
+			{
+				int m_fd;
+				~FdCloser()
+				{
+#ifdef _WIN32
+					::_close(m_fd);
+#else
+					::close(m_fd);
+#endif
+				}
+			} closer{ fd };
+			ingestFd(fd, bufferSize);
+		}
+
+		//ends the current batch and emits the changes
+		void flush()
+		{
+			closeBatchesInternal();
+			m_pendingCount = 0;
+			m_root.emit();
+			//the slots might have restructured the hierarchy
+			validateCacheInternal();
+		}
+
+		//forgets the resolved paths and names
+		void clearCache()
+		{
+			m_targets.clear();
+			m_targetKeys.clear();
+			m_containers.clear();
+		}
+
+		//the maximum number of resolved paths and of resolved path and name pairs that are cached
+		void setMaxCacheSize(size_t maxCacheSize) noexcept
+		{
+			m_maxCacheSize = maxCacheSize ? maxCacheSize : 1;
+		}
+
+		[[nodiscard]] size_t getAppliedCount() const noexcept
+		{
+			return m_appliedCount;
+		}
+
+		[[nodiscard]] size_t getRejectedCount() const noexcept
+		{
+			return m_rejectedCount;
+		}
+
+	private:
+		void closeBatchesInternal()
+		{
+			m_batches.clear();
+			++m_batchNumber;
+		}
+
+		void validateCacheInternal()
+		{
+			auto generation = m_root.getHierarchyGeneration();
+			const uint64_t structure = generation->m_structure.load(std::memory_order_relaxed);
+			if (generation == m_cacheGeneration && structure == m_cacheStructure)
+				return;
+			clearCache();
+			m_cacheGeneration = std::move(generation);
+			m_cacheStructure = structure;
+		}
+
+		void applyRecordInternal(std::string_view record)
+		{
+			if (!record.empty() && record.back() == '\r')
+				record.remove_suffix(1);
+			if (record.empty() || record.front() == '#')
+				return;
+			const size_t pathEnd = record.find(' ');
+			const size_t nameEnd = pathEnd == std::string_view::npos ? pathEnd : record.find(' ', pathEnd + 1);
+			const Target* target = nameEnd != std::string_view::npos ? findTargetInternal(record.substr(0, nameEnd), pathEnd) : nullptr;
+			if (!target)
+			{
+				++m_rejectedCount;
+				return;
+			}
+			ContainerEntry& entry = *target->m_entry;
+			if (entry.m_batchNumber != m_batchNumber)
+			{
+				entry.m_batchNumber = m_batchNumber;
+				m_batches.push_back(entry.m_container->batch());
+			}
+			if (target->m_pd->setPropertyFromInput(*entry.m_container, record.substr(nameEnd + 1)))
+				++m_appliedCount;
+			else
+				++m_rejectedCount;
+			if (++m_pendingCount == m_batchSize)
+				flush();
+		}
+
+		const Target* findTargetInternal(std::string_view key, size_t pathEnd)
+		{
+			if (auto it = m_targets.find(key); it != m_targets.end())
+				return &it->second;
+			const auto* pd = m_registry.find(key.substr(pathEnd + 1));
+			if (!pd)
+				return nullptr;
+			if (m_targets.size() >= m_maxCacheSize || m_containers.size() >= m_maxCacheSize)
+				clearCache();
+			ContainerEntry* entry = findContainerInternal(key.substr(0, pathEnd));
+			if (!entry)
+				return nullptr;
+			const std::string_view ownedKey = m_targetKeys.emplace_back(key);
+			return &m_targets.emplace(ownedKey, Target{ entry, pd }).first->second;
+		}
+
+		ContainerEntry* findContainerInternal(std::string_view path)
+		{
+			if (auto it = m_containers.find(std::string(path)); it != m_containers.end())
+				return &it->second;
+			PropertyContainer* container = &m_root;
+			std::string_view remainingPath = path;
+			while (!remainingPath.empty())
+			{
+				if (remainingPath.front() == '/')
+				{
+					remainingPath.remove_prefix(1);
+					continue;
+				}
+				const size_t segmentEnd = std::min(remainingPath.find('/'), remainingPath.size());
+				size_t childIndex = 0;
+				if (!PropertyParser<size_t>::parse(remainingPath.substr(0, segmentEnd), childIndex))
+					return nullptr;
+				remainingPath.remove_prefix(segmentEnd);
+				container = container->getChildContainer(childIndex);
+				if (!container)
+					return nullptr;
+			}
+			return &m_containers.emplace(std::string(path), ContainerEntry{ container }).first->second;
+		}
+	};
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        PropertyParser
+	//#
+	//############################################################################
+
+	//a value for a property that comes from a config file, a command line or an RPC layer
+	//a string is parsed with the PropertyParser of the type of the property, numbers are converted
+	using PropertyInput = std::variant<std::string_view, bool, int64_t, double>;
+
+	//parses the text representation of a value, specialize it to set your own types by name
+	template<typename T, typename = void>
+	struct PropertyParser;
+
+	template<typename T>
+	struct PropertyParser<T, std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>>
+	{
+		static bool parse(std::string_view text, T& value) noexcept
+		{
+			const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+			return error == std::errc() && end == text.data() + text.size();
+		}
+	};
+
+	template<>
+	struct PropertyParser<bool>
+	{
+		static bool parse(std::string_view text, bool& value) noexcept
+		{
+			if (text == "true" || text == "1")
+				value = true;
+			else if (text == "false" || text == "0")
+				value = false;
+			else
+				return false;
+			return true;
+		}
+	};
+
+	template<>
+	struct PropertyParser<std::string>
+	{
+		static bool parse(std::string_view text, std::string& value)
+		{
+			value.assign(text);
+			return true;
+		}
+	};
+
+	template<typename T, typename = void>
+	struct has_property_parser : std::false_type {};
+	template<typename T>
+	struct has_property_parser<T, std::void_t<decltype(PropertyParser<T>::parse(std::declval<std::string_view>(), std::declval<T&>()))>> : std::true_type {};
+	template<typename T>
+	inline constexpr bool has_property_parser_v = has_property_parser<T>::value;
+
+	//true if the number can be converted to T without leaving its range (that would be undefined behavior)
+	template<typename T, typename InputT>
+	bool isRepresentableAs(InputT input) noexcept
+	{
+		if constexpr (std::is_same_v<T, bool> || std::is_same_v<InputT, bool>)
+		{
+			if constexpr (std::is_floating_point_v<InputT>)
+				return !std::isnan(input);
+			return true;
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_integral_v<InputT>)
+		{
+			//the input is int64_t, the widest signed type
+			if constexpr (std::is_signed_v<T>)
+				return input >= std::numeric_limits<T>::min() && input <= std::numeric_limits<T>::max();
+			else
+				return input >= 0 && static_cast<uint64_t>(input) <= std::numeric_limits<T>::max();
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			//max + 1 and min are powers of two, so they are exact as floating point numbers, NaN fails both comparisons
+			const InputT upper = std::ldexp(InputT(1), std::numeric_limits<T>::digits);
+			const InputT lower = std::is_signed_v<T> ? -upper : InputT(0);
+			return input >= lower && input < upper;
+		}
+		else if constexpr (std::is_floating_point_v<InputT> && sizeof(T) < sizeof(InputT))
+		{
+			//infinity and NaN stay what they are
+			return !std::isfinite(input) || std::abs(input) <= std::numeric_limits<T>::max();
+		}
+		else
+			return true;
+	}
+
+	//converts the input to the value type of a property, returns false if that's not possible
+	//numbers outside of the range of the type (and NaN for integral types) are rejected
+	template<typename T>
+	bool parsePropertyInput(const PropertyInput& input, T& value)
+	{
+		return std::visit([&value](const auto& alternative) -> bool {
+			using InputT = std::decay_t<decltype(alternative)>;
+			if constexpr (std::is_same_v<InputT, std::string_view>)
+				return PropertyParser<T>::parse(alternative, value);
+			else if constexpr (std::is_arithmetic_v<T>)
+			{
+				if (!isRepresentableAs<T>(alternative))
+					return false;
+				const T converted = static_cast<T>(alternative);
+				//an integral property only accepts numbers without a fractional part
+				if constexpr (std::is_integral_v<T> && std::is_floating_point_v<InputT>)
+				{
+					if (static_cast<InputT>(converted) != alternative)
+						return false;
+				}
+				value = converted;
+				return true;
+			}
+			else
+				return false;
+		}, input);
+	}
+}
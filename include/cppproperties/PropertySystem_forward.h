@@ -5,18 +5,50 @@ namespace ps
 	//forward declarations
 	template<typename T, typename FuncT, typename ... PropertDescriptors>
 	class ConvertingProxyProperty;
+	template<typename T, typename FuncT, typename ... PropertDescriptors>
+	class LazyProxyProperty;
+	template<typename T, typename FuncT, typename ... PropertDescriptors>
+	class MemoizedProxyProperty;
+	template<typename T, typename ExecutorT, typename FuncT, typename ... PropertDescriptors>
+	class AsyncProxyProperty;
+
+	template<typename KeyT, typename ValueT>
+	class DenseMap;
+
+	template<const auto& ... PDs>
+	class StaticPropertyContainer;
 
-	template<template<typename ...> class MapT = std::unordered_map>
+	template<template<typename ...> class MapT = DenseMap>
 	class PropertyContainerBase;
 	using PropertyContainer = PropertyContainerBase<>;
 
 	class PropertyDescriptorBase;
+	class PropertyDescriptorRegistry;
 	template<typename T>
 	class PropertyDescriptor;
 
 	template<typename T>
 	class ProxyProperty;
 
+	template<typename T, typename ContainerT>
+	class PropertyHandle;
+	template<typename ContainerT>
+	class SnapshotSchema;
+	template<typename ContainerT>
+	class ChangeJournal;
+	template<typename ContainerT>
+	class SharedPropertyPublisher;
+	class SharedPropertyReader;
+	class PropertyIngestor;
+	template<typename ContainerT>
+	class ConcurrentReads;
+	template<typename T>
+	class ConcurrentPropertyView;
+	class EpochDomain;
+
+	template<typename T>
+	class ChangePolicy;
+
 	class PropertyBase;
 	template<typename T>
 	class Property;
@@ -3,6 +3,13 @@
 #include "PropertySystem_forward.h"
 #include "PropertyContainer.h"
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 #include <type_traits>
 
@@ -27,7 +34,7 @@ namespace ps
 	auto make_proxy_property(FuncT&& func, const PropertDescriptors& ... pds)
 	{
 		using ResultT = typename std::invoke_result_t<FuncT, typename PropertDescriptors::value_type...>;
-		return std::make_unique<ConvertingProxyProperty<ResultT, FuncT, PropertDescriptors...>>(std::forward<FuncT>(func), pds..., std::index_sequence_for<PropertDescriptors...>{});
+		return std::make_unique<ConvertingProxyProperty<ResultT, std::decay_t<FuncT>, PropertDescriptors...>>(std::forward<FuncT>(func), pds..., std::index_sequence_for<PropertDescriptors...>{});
 	}
 
 	template<typename T, typename FuncT, typename ... PropertDescriptors>
@@ -38,10 +45,11 @@ namespace ps
 		std::tuple<typename PropertDescriptors::value_type...> m_values;
 		std::tuple<const PropertDescriptors*...> m_pds;
 	public:
-		template<std::size_t... Is>
-		ConvertingProxyProperty(FuncT&& funcT, const PropertDescriptors& ... pds, std::index_sequence<Is...>)
+		//the function is always stored by value, so the proxy property doesn't depend on the lifetime of the passed function
+		template<typename FuncU, std::size_t... Is>
+		ConvertingProxyProperty(FuncU&& funcT, const PropertDescriptors& ... pds, std::index_sequence<Is...>)
 			: ProxyProperty<T>()
-			, m_func(std::forward<FuncT>(funcT))
+			, m_func(std::forward<FuncU>(funcT))
 			, m_values(PropertyContainer::getProperty(pds)...)
 			, m_pds(std::addressof(pds)...)
 		{
@@ -53,16 +61,308 @@ namespace ps
 			anyPropertyChanged();
 		}
 		template<std::size_t... Is>
-		ConvertingProxyProperty(FuncT&& funcT, const std::tuple<const PropertDescriptors *...>& pds, std::index_sequence<Is...> is)
+		ConvertingProxyProperty(const FuncT& funcT, const std::tuple<const PropertDescriptors *...>& pds, std::index_sequence<Is...> is)
 			: ConvertingProxyProperty(funcT, *std::get<Is>(pds)..., is) {};
 		//copying and moving is currently the same for ConvertingProxyProperty
 		ConvertingProxyProperty(const ConvertingProxyProperty& that) : ConvertingProxyProperty(that.m_func, that.m_pds, std::index_sequence_for<PropertDescriptors...>{}) {};
 		ConvertingProxyProperty(ConvertingProxyProperty&& that) : ConvertingProxyProperty(that.m_func, that.m_pds, std::index_sequence_for<PropertDescriptors...>{}) {};
 
 	protected:
-		void anyPropertyChanged()
+		virtual void anyPropertyChanged()
 		{
 			Property<T>::set(std::apply(m_func, m_values));
 		}
 	};
-}
\ No newline at end of file
+
+	//###########################################################################
+	//#
+	//#              make_lazy_proxy_property and LazyProxyProperty
+	//#
+	//############################################################################
+
+	//same as make_proxy_property, but the function isn't invoked for every changed input
+	//a change of an input only marks the proxy property as stale, the function is invoked once
+	//when the container that owns the proxy property is emitted, before its signals are emitted
+	//so if N inputs change within one frame the function is only invoked once instead of N times
+	//until then get() returns the previous result, reading the value never invokes the function
+	//if the function throws, the previous result is kept and the exception is stored (see getException)
+	template<typename FuncT, typename ... PropertDescriptors>
+	auto make_lazy_proxy_property(FuncT&& func, const PropertDescriptors& ... pds)
+	{
+		using ResultT = typename std::invoke_result_t<FuncT, typename PropertDescriptors::value_type...>;
+		return std::make_unique<LazyProxyProperty<ResultT, std::decay_t<FuncT>, PropertDescriptors...>>(std::forward<FuncT>(func), pds..., std::index_sequence_for<PropertDescriptors...>{});
+	}
+
+	template<typename T, typename FuncT, typename ... PropertDescriptors>
+	class LazyProxyProperty : public ConvertingProxyProperty<T, FuncT, PropertDescriptors...>
+	{
+		using BaseT = ConvertingProxyProperty<T, FuncT, PropertDescriptors...>;
+		bool m_isStale = false;
+		std::exception_ptr m_exception;
+	public:
+		using BaseT::BaseT;
+
+		//true while an input changed and the value wasn't recomputed yet
+		bool isStale() const noexcept
+		{
+			return m_isStale;
+		}
+		//the exception the function threw for the latest inputs, nullptr if it succeeded
+		std::exception_ptr getException() const noexcept
+		{
+			return m_exception;
+		}
+
+	protected:
+		void anyPropertyChanged() override
+		{
+			if (m_isStale)
+				return;
+			m_isStale = true;
+			this->requestEmit();
+		}
+
+		void onEmit() override
+		{
+			if (!m_isStale)
+				return;
+			m_isStale = false;
+			try
+			{
+				BaseT::anyPropertyChanged();
+				m_exception = nullptr;
+			}
+			catch (...)
+			{
+				m_exception = std::current_exception();
+			}
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#              make_memoized_proxy_property and MemoizedProxyProperty
+	//#
+	//############################################################################
+
+	//same as make_proxy_property, but the results of the last 'capacity' distinct inputs are cached
+	//this makes sense for pure, expensive functions whose inputs switch between a few values (e.g. a translation for the current language)
+	//the input values have to be hashable (std::hash) and equality comparable
+	template<typename FuncT, typename ... PropertDescriptors>
+	auto make_memoized_proxy_property(size_t capacity, FuncT&& func, const PropertDescriptors& ... pds)
+	{
+		using ResultT = typename std::invoke_result_t<FuncT, typename PropertDescriptors::value_type...>;
+		return std::make_unique<MemoizedProxyProperty<ResultT, std::decay_t<FuncT>, PropertDescriptors...>>(capacity, std::forward<FuncT>(func), pds..., std::index_sequence_for<PropertDescriptors...>{});
+	}
+
+	template<typename T, typename FuncT, typename ... PropertDescriptors>
+	class MemoizedProxyProperty : public ConvertingProxyProperty<T, FuncT, PropertDescriptors...>
+	{
+		using BaseT = ConvertingProxyProperty<T, FuncT, PropertDescriptors...>;
+		using ValuesT = std::tuple<typename PropertDescriptors::value_type...>;
+
+		struct ValuesHash
+		{
+			size_t operator()(const ValuesT& values) const
+			{
+				return std::apply([](const auto& ... value) {
+					size_t h = 0;
+					((h ^= std::hash<std::decay_t<decltype(value)>>{}(value) + 0x9E3779B9u + (h << 6) + (h >> 2)), ...);
+					return h;
+				}, values);
+			}
+		};
+		//the most recently used result is at the front
+		using CacheListT = std::list<std::pair<ValuesT, T>>;
+
+		size_t m_capacity;
+		CacheListT m_cache;
+		std::unordered_map<ValuesT, typename CacheListT::iterator, ValuesHash> m_cacheIndex;
+		size_t m_hitCount = 0;
+		size_t m_missCount = 0;
+	public:
+		template<typename FuncU, std::size_t... Is>
+		MemoizedProxyProperty(size_t capacity, FuncU&& funcT, const PropertDescriptors& ... pds, std::index_sequence<Is...> is)
+			: BaseT(std::forward<FuncU>(funcT), pds..., is)
+			, m_capacity(capacity)
+		{
+			m_cacheIndex.reserve(capacity);
+		}
+		//the cache isn't copied, it refers to its own list
+		MemoizedProxyProperty(const MemoizedProxyProperty& that) : BaseT(that), m_capacity(that.m_capacity) {}
+		MemoizedProxyProperty(MemoizedProxyProperty&& that) : BaseT(that), m_capacity(that.m_capacity) {}
+
+		size_t getHitCount() const noexcept { return m_hitCount; }
+		size_t getMissCount() const noexcept { return m_missCount; }
+		size_t getCacheSize() const noexcept { return m_cache.size(); }
+
+		void clearCache()
+		{
+			m_cacheIndex.clear();
+			m_cache.clear();
+		}
+
+	protected:
+		void anyPropertyChanged() override
+		{
+			if (m_capacity == 0)
+			{
+				++m_missCount;
+				BaseT::anyPropertyChanged();
+				return;
+			}
+			if (auto cacheIt = m_cacheIndex.find(this->m_values); cacheIt != m_cacheIndex.end())
+			{
+				++m_hitCount;
+				m_cache.splice(m_cache.begin(), m_cache, cacheIt->second);
+				Property<T>::set(cacheIt->second->second);
+				return;
+			}
+			++m_missCount;
+			T result = std::apply(this->m_func, this->m_values);
+			if (m_cache.size() == m_capacity)
+			{
+				//the least recently used node is reused for the new entry
+				m_cacheIndex.erase(m_cache.back().first);
+				m_cache.splice(m_cache.begin(), m_cache, std::prev(m_cache.end()));
+				m_cache.front() = { this->m_values, std::move(result) };
+			}
+			else
+				m_cache.emplace_front(this->m_values, std::move(result));
+			m_cacheIndex.emplace(m_cache.front().first, m_cache.begin());
+			Property<T>::set(m_cache.front().second);
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#              make_async_proxy_property and AsyncProxyProperty
+	//#
+	//############################################################################
+
+	//same as make_proxy_property, but the function is invoked on the given executor
+	//(anything with a submit(task) member function, e.g. ps::ThreadPool) instead of within the emit
+	//the inputs are copied when one of them changes, the result is published at the start of an emit
+	//after it's ready, results of inputs that changed again in the meantime are discarded
+	//the function has to be safe to be invoked concurrently and the executor has to outlive the proxy property
+	//container.setProperty(PathPD, ps::make_async_proxy_property(threadPool, planPath, StartPD, GoalPD));
+	template<typename ExecutorT, typename FuncT, typename ... PropertDescriptors>
+	auto make_async_proxy_property(ExecutorT& executor, FuncT&& func, const PropertDescriptors& ... pds)
+	{
+		using ResultT = typename std::invoke_result_t<FuncT, typename PropertDescriptors::value_type...>;
+		return std::make_unique<AsyncProxyProperty<ResultT, ExecutorT, std::decay_t<FuncT>, PropertDescriptors...>>(executor, std::forward<FuncT>(func), pds..., std::index_sequence_for<PropertDescriptors...>{});
+	}
+
+	template<typename T, typename ExecutorT, typename FuncT, typename ... PropertDescriptors>
+	class AsyncProxyProperty : public ProxyProperty<T>
+	{
+	protected:
+		using ValuesT = std::tuple<typename PropertDescriptors::value_type...>;
+
+		//shared with the running computations, so they can finish after the proxy property is gone
+		struct SharedState
+		{
+			explicit SharedState(FuncT func)
+				: m_func(std::move(func)) {}
+
+			const FuncT m_func;
+			//the generation of the most recent inputs, older computations don't need to run anymore
+			std::atomic<uint64_t> m_requestedGeneration{ 0 };
+			std::mutex m_mutex;
+			std::optional<T> m_result;
+			std::exception_ptr m_exception;
+			uint64_t m_resultGeneration = 0;
+		};
+
+		ExecutorT* m_executor;
+		std::shared_ptr<SharedState> m_state;
+		ValuesT m_values;
+		std::tuple<const PropertDescriptors*...> m_pds;
+		uint64_t m_generation = 0;
+		uint64_t m_publishedGeneration = 0;
+		std::exception_ptr m_exception;
+	public:
+		template<typename FuncU, std::size_t... Is>
+		AsyncProxyProperty(ExecutorT& executor, FuncU&& func, const PropertDescriptors& ... pds, std::index_sequence<Is...>)
+			: ProxyProperty<T>()
+			, m_executor(&executor)
+			, m_state(std::make_shared<SharedState>(std::forward<FuncU>(func)))
+			, m_values(PropertyContainer::getProperty(pds)...)
+			, m_pds(std::addressof(pds)...)
+		{
+			((void)PropertyContainer::connect(pds, [this](const typename PropertDescriptors::value_type& value) {
+				std::get<Is>(m_values) = value;
+				anyPropertyChanged();
+			}), ...);
+
+			anyPropertyChanged();
+		}
+		AsyncProxyProperty(const AsyncProxyProperty& that)
+			: AsyncProxyProperty(*that.m_executor, that.m_state->m_func, that.m_pds, std::index_sequence_for<PropertDescriptors...>{}) {}
+
+		//true while the result for the latest inputs hasn't been published yet
+		bool isPending() const noexcept
+		{
+			return m_publishedGeneration != m_generation;
+		}
+		//if the function threw for the latest inputs the value is kept and the exception is stored here
+		std::exception_ptr getException() const noexcept
+		{
+			return m_exception;
+		}
+
+	protected:
+		template<std::size_t... Is>
+		AsyncProxyProperty(ExecutorT& executor, const FuncT& func, const std::tuple<const PropertDescriptors*...>& pds, std::index_sequence<Is...> is)
+			: AsyncProxyProperty(executor, func, *std::get<Is>(pds)..., is) {}
+
+		void anyPropertyChanged()
+		{
+			const uint64_t generation = ++m_generation;
+			m_state->m_requestedGeneration.store(generation, std::memory_order_relaxed);
+			m_executor->submit([state = m_state, values = m_values, generation]() {
+				if (state->m_requestedGeneration.load(std::memory_order_relaxed) != generation)
+					return;
+				std::optional<T> result;
+				std::exception_ptr exception;
+				try
+				{
+					result.emplace(std::apply(state->m_func, values));
+				}
+				catch (...)
+				{
+					exception = std::current_exception();
+				}
+				std::lock_guard lock(state->m_mutex);
+				if (generation > state->m_resultGeneration)
+				{
+					state->m_result = std::move(result);
+					state->m_exception = exception;
+					state->m_resultGeneration = generation;
+				}
+			});
+			this->requestPreEmit();
+		}
+
+		//polls for the result of the latest inputs, as long as it isn't there we ask to be polled again
+		void onPreEmit() override
+		{
+			if (!isPending())
+				return;
+			std::optional<T> result;
+			{
+				std::lock_guard lock(m_state->m_mutex);
+				if (m_state->m_resultGeneration != m_generation)
+				{
+					this->requestPreEmit();
+					return;
+				}
+				result = std::exchange(m_state->m_result, std::nullopt);
+				m_exception = std::exchange(m_state->m_exception, nullptr);
+			}
+			m_publishedGeneration = m_generation;
+			if (result)
+				Property<T>::set(std::move(*result));
+		}
+	};
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+#include "SharedPropertyReader.h"
+
+//the shared property segments use POSIX shared memory, they aren't available on Windows
+#ifndef _WIN32
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        SharedPropertyPublisher
+	//#
+	//############################################################################
+
+	//exports the values of selected PDs of a container into a POSIX shared memory segment,
+	//so other processes can read them with a SharedPropertyReader (without system calls or locks)
+	//the values are written when the container emits them, they are the values the container sees (including
+	//properties that are owned by a parent), only trivially copyable values can be published
+	//	ps::SharedPropertyPublisher<> publisher("/game", root);
+	//	publisher.add(HealthPD);
+	//	publisher.publish();
+	//the segment is removed when the publisher is destroyed, the publisher has to be destroyed before the container
+	template<typename ContainerT = PropertyContainer>
+	class SharedPropertyPublisher
+	{
+		struct Entry
+		{
+			const PropertyDescriptorBase* m_pd = nullptr;
+			uint32_t m_valueSize = 0;
+			//connects the slot to the container and writes the current value
+			size_t(*m_connect)(ContainerT& container, const PropertyDescriptorBase& pd, SharedPropertySegment::Slot& slot) = nullptr;
+			void(*m_disconnect)(ContainerT& container, const PropertyDescriptorBase& pd, size_t index) = nullptr;
+			size_t m_connectionIndex = 0;
+		};
+
+		std::string m_segmentName;
+		ContainerT& m_container;
+		std::vector<Entry> m_entries;
+		char* m_data = nullptr;
+		size_t m_size = 0;
+
+		static size_t alignSlot(size_t offset) noexcept
+		{
+			return (offset + SharedPropertySegment::s_slotAlignment - 1) & ~(SharedPropertySegment::s_slotAlignment - 1);
+		}
+
+		SharedPropertySegment::Header& header() noexcept
+		{
+			return *reinterpret_cast<SharedPropertySegment::Header*>(m_data);
+		}
+
+	public:
+		SharedPropertyPublisher(std::string segmentName, ContainerT& container)
+			: m_segmentName(std::move(segmentName))
+			, m_container(container)
+		{
+		}
+		SharedPropertyPublisher(const SharedPropertyPublisher&) = delete;
+		SharedPropertyPublisher& operator=(const SharedPropertyPublisher&) = delete;
+		~SharedPropertyPublisher()
+		{
+			if (!m_data)
+				return;
+			for (const auto& entry : m_entries)
+				entry.m_disconnect(m_container, *entry.m_pd, entry.m_connectionIndex);
+			//readers that still have the segment mapped keep the last values
+			header().m_state.store(SharedPropertySegment::State::Closed, std::memory_order_release);
+			::munmap(m_data, m_size);
+			::shm_unlink(m_segmentName.c_str());
+		}
+
+		//the PD has to have a name, the readers find the value by it
+		//all PDs have to be added before publish is called
+		//throws std::invalid_argument if the PD has no name or the name is longer than SharedPropertySegment::s_maxNameSize
+		template<typename T>
+		void add(const PropertyDescriptor<T>& pd)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be shared");
+			assert(!m_data && "PDs have to be added before the segment is published");
+			if (pd.getName().empty() || pd.getName().size() > SharedPropertySegment::s_maxNameSize)
+				throw std::invalid_argument("SharedPropertyPublisher: the name of the PD '" + pd.getName() + "' can't be shared");
+			Entry entry;
+			entry.m_pd = &pd;
+			entry.m_valueSize = static_cast<uint32_t>(sizeof(T));
+			entry.m_connect = +[](ContainerT& container, const PropertyDescriptorBase& pd, SharedPropertySegment::Slot& slot) -> size_t {
+				const auto& typedPD = static_cast<const PropertyDescriptor<T>&>(pd);
+				SharedPropertySegment::write(slot, &container.getProperty(typedPD).get(), sizeof(T));
+				return container.connect(typedPD, [&slot](const T& value) { SharedPropertySegment::write(slot, &value, sizeof(T)); });
+			};
+			entry.m_disconnect = +[](ContainerT& container, const PropertyDescriptorBase& pd, size_t index) {
+				container.disconnect(static_cast<const PropertyDescriptor<T>&>(pd), index);
+			};
+			m_entries.push_back(entry);
+		}
+
+		//creates the segment (replacing an existing one with the same name) and writes the current values
+		//throws std::runtime_error if the segment can't be created
+		void publish(mode_t mode = 0600)
+		{
+			assert(!m_data && "the segment is already published");
+			const size_t slotTableEnd = sizeof(SharedPropertySegment::Header) + m_entries.size() * sizeof(SharedPropertySegment::SlotInfo);
+			std::vector<uint32_t> offsets;
+			size_t size = alignSlot(slotTableEnd);
+			for (const auto& entry : m_entries)
+			{
+				offsets.push_back(static_cast<uint32_t>(size));
+				size = alignSlot(size + sizeof(SharedPropertySegment::Slot) + entry.m_valueSize);
+			}
+
+			::shm_unlink(m_segmentName.c_str());
+			const int fd = ::shm_open(m_segmentName.c_str(), O_CREAT | O_EXCL | O_RDWR, mode);
+			if (fd < 0)
+				throw std::runtime_error("SharedPropertyPublisher: can't create " + m_segmentName);
+			if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+			{
+				::close(fd);
+				::shm_unlink(m_segmentName.c_str());
+				throw std::runtime_error("SharedPropertyPublisher: can't resize " + m_segmentName);
+			}
+			void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (data == MAP_FAILED)
+			{
+				::shm_unlink(m_segmentName.c_str());
+				throw std::runtime_error("SharedPropertyPublisher: can't map " + m_segmentName);
+			}
+			auto* segment = static_cast<char*>(data);
+
+			//the segment is zero initialized, the readers wait until the state is published
+			auto* header = new (segment) SharedPropertySegment::Header{};
+			std::memcpy(header->m_magic, SharedPropertySegment::s_magic, sizeof(SharedPropertySegment::s_magic));
+			header->m_version = SharedPropertySegment::s_version;
+			header->m_slotCount = static_cast<uint32_t>(m_entries.size());
+			header->m_size = size;
+			auto* slotInfos = reinterpret_cast<SharedPropertySegment::SlotInfo*>(segment + sizeof(SharedPropertySegment::Header));
+			size_t connected = 0;
+			try
+			{
+				for (; connected < m_entries.size(); ++connected)
+				{
+					auto& entry = m_entries[connected];
+					const auto& name = entry.m_pd->getName();
+					std::memcpy(slotInfos[connected].m_name, name.data(), name.size());
+					slotInfos[connected].m_valueSize = entry.m_valueSize;
+					slotInfos[connected].m_offset = offsets[connected];
+					auto* slot = new (segment + offsets[connected]) SharedPropertySegment::Slot{};
+					slot->m_valueSize = entry.m_valueSize;
+					entry.m_connectionIndex = entry.m_connect(m_container, *entry.m_pd, *slot);
+				}
+			}
+			catch (...)
+			{
+				//only the entries that were connected are disconnected, the segment is never published
+				for (size_t i = 0; i < connected; ++i)
+					m_entries[i].m_disconnect(m_container, *m_entries[i].m_pd, m_entries[i].m_connectionIndex);
+				::munmap(segment, size);
+				::shm_unlink(m_segmentName.c_str());
+				throw;
+			}
+			m_data = segment;
+			m_size = size;
+			header->m_state.store(SharedPropertySegment::State::Published, std::memory_order_release);
+		}
+
+		[[nodiscard]] const std::string& getSegmentName() const noexcept
+		{
+			return m_segmentName;
+		}
+	};
+}
+
+#endif
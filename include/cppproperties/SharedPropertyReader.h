@@ -0,0 +1,240 @@
+#pragma once
+
+//the shared property segments use POSIX shared memory, they aren't available on Windows
+#ifndef _WIN32
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        SharedPropertySegment
+	//#
+	//############################################################################
+
+	//the layout of a shared memory segment that is written by a SharedPropertyPublisher
+	//header, slot table, then the slots, every slot starts on its own cache line:
+	//[sequence][value size][value]
+	//the value of a slot is protected by a seqlock: the publisher makes the sequence odd while it writes the value,
+	//a reader copies the value and retries if the sequence was odd or has changed in between
+	namespace SharedPropertySegment
+	{
+		inline constexpr char s_magic[4] = { 'C', 'P', 'P', 'M' };
+		inline constexpr uint32_t s_version = 1;
+		inline constexpr size_t s_maxNameSize = 55;
+		inline constexpr size_t s_slotAlignment = 64;
+
+		enum class State : uint32_t
+		{
+			Initializing,
+			Published,
+			Closed
+		};
+
+		struct Header
+		{
+			char m_magic[4];
+			uint32_t m_version;
+			uint32_t m_slotCount;
+			std::atomic<State> m_state;
+			uint64_t m_size;
+		};
+
+		struct SlotInfo
+		{
+			char m_name[s_maxNameSize + 1];
+			uint32_t m_valueSize;
+			uint32_t m_offset;
+		};
+
+		//the value follows the slot
+		struct Slot
+		{
+			std::atomic<uint32_t> m_sequence;
+			uint32_t m_valueSize;
+		};
+		inline unsigned char* valueOf(Slot& slot) noexcept
+		{
+			return reinterpret_cast<unsigned char*>(&slot) + sizeof(Slot);
+		}
+		inline const unsigned char* valueOf(const Slot& slot) noexcept
+		{
+			return reinterpret_cast<const unsigned char*>(&slot) + sizeof(Slot);
+		}
+
+		static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<State>::is_always_lock_free, "the atomics in shared memory have to be lock free");
+		static_assert(std::is_standard_layout_v<Header> && std::is_standard_layout_v<Slot>);
+
+		//called by the publisher only, the values are written by a single thread per slot
+		inline void write(Slot& slot, const void* value, size_t size) noexcept
+		{
+			const uint32_t sequence = slot.m_sequence.load(std::memory_order_relaxed);
+			slot.m_sequence.store(sequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			std::memcpy(valueOf(slot), value, size);
+			slot.m_sequence.store(sequence + 2, std::memory_order_release);
+		}
+	}
+
+	//###########################################################################
+	//#
+	//#                        SharedPropertyView
+	//#
+	//############################################################################
+
+	//reads the value of one published property, see SharedPropertyReader::find
+	//the view is only valid as long as the reader it was created with
+	template<typename T>
+	class SharedPropertyView
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be shared");
+		const SharedPropertySegment::Slot* m_slot = nullptr;
+	public:
+		SharedPropertyView() = default;
+		explicit SharedPropertyView(const SharedPropertySegment::Slot& slot) noexcept
+			: m_slot(&slot) {}
+
+		//returns a consistent copy of the value, it only waits while the publisher writes this value
+		[[nodiscard]] T read() const noexcept
+		{
+			T value;
+			while (!tryRead(value))
+			{
+			}
+			return value;
+		}
+
+		//a single attempt, returns false if the publisher was writing the value at the same time
+		bool tryRead(T& value) const noexcept
+		{
+			const uint32_t sequence = m_slot->m_sequence.load(std::memory_order_acquire);
+			if (sequence & 1)
+				return false;
+			//the copy can race with the publisher, a torn copy is detected by the changed sequence and discarded
+			std::memcpy(&value, SharedPropertySegment::valueOf(*m_slot), sizeof(T));
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return m_slot->m_sequence.load(std::memory_order_relaxed) == sequence;
+		}
+
+		//changes every time the value is published, e.g. to skip work if nothing has changed
+		[[nodiscard]] uint32_t getVersion() const noexcept
+		{
+			return m_slot->m_sequence.load(std::memory_order_acquire) >> 1;
+		}
+
+		[[nodiscard]] explicit operator bool() const noexcept
+		{
+			return m_slot != nullptr;
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#                        SharedPropertyReader
+	//#
+	//############################################################################
+
+	//maps the segment of a SharedPropertyPublisher (in another process) read only
+	//the values are read without system calls or locks, the reader doesn't depend on the rest of the library
+	//	ps::SharedPropertyReader reader("/game");
+	//	auto health = reader.find<int>("health");
+	//	int value = health.read();
+	class SharedPropertyReader
+	{
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+
+		const SharedPropertySegment::Header& header() const noexcept
+		{
+			return *reinterpret_cast<const SharedPropertySegment::Header*>(m_data);
+		}
+		const SharedPropertySegment::SlotInfo* slotInfos() const noexcept
+		{
+			return reinterpret_cast<const SharedPropertySegment::SlotInfo*>(m_data + sizeof(SharedPropertySegment::Header));
+		}
+	public:
+		//throws std::runtime_error if the segment doesn't exist or isn't published yet
+		explicit SharedPropertyReader(const std::string& segmentName)
+		{
+			const int fd = ::shm_open(segmentName.c_str(), O_RDONLY, 0);
+			if (fd < 0)
+				throw std::runtime_error("SharedPropertyReader: can't open " + segmentName);
+			struct stat fileStat;
+			if (::fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(SharedPropertySegment::Header))
+			{
+				::close(fd);
+				throw std::runtime_error("SharedPropertyReader: " + segmentName + " isn't published yet");
+			}
+			m_size = static_cast<size_t>(fileStat.st_size);
+			void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (data == MAP_FAILED)
+				throw std::runtime_error("SharedPropertyReader: can't map " + segmentName);
+			m_data = static_cast<const char*>(data);
+			//the state is published last, so it has to be checked first
+			if (header().m_state.load(std::memory_order_acquire) == SharedPropertySegment::State::Initializing
+				|| std::memcmp(header().m_magic, SharedPropertySegment::s_magic, sizeof(SharedPropertySegment::s_magic)) != 0
+				|| header().m_version != SharedPropertySegment::s_version
+				|| header().m_size != m_size
+				|| sizeof(SharedPropertySegment::Header) + uint64_t{ header().m_slotCount } * sizeof(SharedPropertySegment::SlotInfo) > m_size)
+			{
+				::munmap(const_cast<char*>(m_data), m_size);
+				throw std::runtime_error("SharedPropertyReader: " + segmentName + " isn't a published property segment");
+			}
+		}
+		SharedPropertyReader(const SharedPropertyReader&) = delete;
+		SharedPropertyReader& operator=(const SharedPropertyReader&) = delete;
+		SharedPropertyReader(SharedPropertyReader&& other) noexcept
+			: m_data(std::exchange(other.m_data, nullptr))
+			, m_size(std::exchange(other.m_size, 0))
+		{
+		}
+		~SharedPropertyReader()
+		{
+			if (m_data)
+				::munmap(const_cast<char*>(m_data), m_size);
+		}
+
+		//returns the view of the property with this name (the name of its PD)
+		//throws std::runtime_error if there is no such property, it has a different size than T or its slot is outside of the segment
+		template<typename T>
+		[[nodiscard]] SharedPropertyView<T> find(std::string_view name) const
+		{
+			const auto* infos = slotInfos();
+			for (uint32_t i = 0; i < header().m_slotCount; ++i)
+			{
+				//the segment isn't trusted, the name might not be terminated
+				if (name != std::string_view(infos[i].m_name, ::strnlen(infos[i].m_name, sizeof(infos[i].m_name))))
+					continue;
+				if (infos[i].m_valueSize != sizeof(T))
+					throw std::runtime_error("SharedPropertyReader: the size of " + std::string(name) + " doesn't match the type");
+				if (infos[i].m_offset % SharedPropertySegment::s_slotAlignment != 0
+					|| uint64_t{ infos[i].m_offset } + sizeof(SharedPropertySegment::Slot) + infos[i].m_valueSize > m_size)
+					throw std::runtime_error("SharedPropertyReader: the slot of " + std::string(name) + " is outside of the segment");
+				return SharedPropertyView<T>(*reinterpret_cast<const SharedPropertySegment::Slot*>(m_data + infos[i].m_offset));
+			}
+			throw std::runtime_error("SharedPropertyReader: " + std::string(name) + " isn't published");
+		}
+
+		//false once the publisher is destroyed, the values keep their last state then
+		[[nodiscard]] bool isPublished() const noexcept
+		{
+			return header().m_state.load(std::memory_order_acquire) == SharedPropertySegment::State::Published;
+		}
+	};
+}
+
+#endif
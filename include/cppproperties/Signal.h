@@ -1,9 +1,12 @@
 #pragma once
-#include <unordered_map>
-#include <unordered_set>
+#include "InplaceFunction.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <type_traits>
 #include <typeindex>
-#include <functional>
+#include <vector>
 
 namespace ps
 {
@@ -32,21 +35,82 @@ namespace ps
 	//specialized signal implementation suited to our needs
 	//it handles class ptr + PMF (with or without argument)
 	//it handles callable funtors (with or without argument)
-	//the underlying storage uses std::function<void()>
-	//and a specialized lambda funtion to abstract the different cases
+	//the slots are stored contiguously, each one holding an InplaceFunction
+	//so connecting and emitting doesn't involve any hashing or node based containers
 	//another requirement is that you can't add the same PMF twice
+	//connecting or disconnecting from within a slot while the signal is emitting is allowed:
+	//new slots are appended once the emit has finished, disconnected slots are skipped
 	template<typename... Args>
 	class Signal
 	{
 	protected:
-		std::unordered_map<size_t, std::function<void(Args...)>> m_slots;
+		static constexpr size_t s_disconnected = static_cast<size_t>(-1);
+
+		struct Slot
+		{
+			size_t m_id = s_disconnected;
+			//only member function pointers are unique per instance, lambdas are always invoked
+			bool m_unique = false;
+			InplaceFunction<void(Args...)> m_func;
+		};
+
+		std::vector<Slot> m_slots;
+		//slots that were connected during an emit
+		std::vector<Slot> m_pendingSlots;
 		size_t m_index = 0;
+		size_t m_connectedCount = 0;
+		uint32_t m_emitDepth = 0;
+
+		template<typename FuncT>
+		void addSlot(size_t id, bool unique, FuncT&& func)
+		{
+			auto& slots = m_emitDepth ? m_pendingSlots : m_slots;
+			slots.push_back({ id, unique, std::forward<FuncT>(func) });
+			++m_connectedCount;
+		}
+
+		bool isConnected(size_t id) const noexcept
+		{
+			auto isSame = [id](const Slot& slot) { return slot.m_id == id; };
+			return std::any_of(m_slots.begin(), m_slots.end(), isSame) || std::any_of(m_pendingSlots.begin(), m_pendingSlots.end(), isSame);
+		}
+
+		void endEmit()
+		{
+			if (--m_emitDepth != 0)
+				return;
+			if (m_slots.size() != m_connectedCount - m_pendingSlots.size())
+				m_slots.erase(std::remove_if(m_slots.begin(), m_slots.end(), [](const Slot& slot) { return slot.m_id == s_disconnected; }), m_slots.end());
+			if (!m_pendingSlots.empty())
+			{
+				std::move(m_pendingSlots.begin(), m_pendingSlots.end(), std::back_inserter(m_slots));
+				m_pendingSlots.clear();
+			}
+		}
 	public:
 		Signal() = default;
+		//a copy gets the connected slots, but never the state of an ongoing emit
+		Signal(const Signal& other)
+			: m_index(other.m_index)
+		{
+			copySlots(other);
+		}
+		Signal(Signal&&) noexcept = default;
+		Signal& operator=(Signal&&) noexcept = default;
+		Signal& operator=(const Signal& other)
+		{
+			if (this != &other)
+			{
+				disconnect();
+				m_index = other.m_index;
+				copySlots(other);
+			}
+			return *this;
+		}
 
 		bool empty() const noexcept
 		{
-			return m_slots.empty();
+			return m_connectedCount == 0;
 		}
 
 		template<typename FuncT>
@@ -54,14 +118,14 @@ namespace ps
 		{
 			if constexpr (std::is_invocable_v<FuncT, void>)
 			{
-				m_slots.try_emplace(m_index, [func = std::forward<FuncT>(func)](Args...)
+				addSlot(m_index, false, [func = std::forward<FuncT>(func)](Args...)
 				{
 					func();
 				});
 			}
 			else
 			{
-				m_slots.try_emplace(m_index, std::forward<FuncT>(func));
+				addSlot(m_index, false, std::forward<FuncT>(func));
 			}
 
 			return m_index++;
@@ -70,19 +134,131 @@ namespace ps
 		// disconnects all previously connected functions
 		void disconnect()
 		{
-			m_slots.clear();
+			m_pendingSlots.clear();
+			if (m_emitDepth)
+			{
+				for (auto& slot : m_slots)
+					slot.m_id = s_disconnected;
+			}
+			else
+				m_slots.clear();
+			m_connectedCount = 0;
 		}
 		//disconnects the function with the given type index
 		void disconnect(size_t idx)
 		{
-			m_slots.erase(idx);
+			auto isSame = [idx](const Slot& slot) { return slot.m_id == idx; };
+			if (auto it = std::find_if(m_pendingSlots.begin(), m_pendingSlots.end(), isSame); it != m_pendingSlots.end())
+			{
+				m_pendingSlots.erase(it);
+				--m_connectedCount;
+				return;
+			}
+			auto it = std::find_if(m_slots.begin(), m_slots.end(), isSame);
+			if (it == m_slots.end())
+				return;
+			//a slot might disconnect itself, so it must stay alive until the emit is done
+			if (m_emitDepth)
+				it->m_id = s_disconnected;
+			else
+				m_slots.erase(it);
+			--m_connectedCount;
 		}
 
 		// calls all connected functions
-		void emit(Args... args) const
+		void emit(Args... args)
+		{
+			++m_emitDepth;
+			for (size_t i = 0, size = m_slots.size(); i < size; ++i)
+			{
+				if (m_slots[i].m_id != s_disconnected)
+					m_slots[i].m_func(args...);
+			}
+			endEmit();
+		}
+
+	private:
+		void copySlots(const Signal& other)
+		{
+			for (const auto* slots : { &other.m_slots, &other.m_pendingSlots })
+			{
+				for (const auto& slot : *slots)
+				{
+					if (slot.m_id != s_disconnected)
+						m_slots.push_back(slot);
+				}
+			}
+			m_connectedCount = m_slots.size();
+		}
+	};
+
+	//set of (instance, slot id) pairs that have already been invoked during an emit
+	//open addressing with generation stamps: clear only bumps the generation and keeps the storage,
+	//so once the table has grown to its working size inserting doesn't allocate anymore
+	class InvocationSet
+	{
+		struct Entry
+		{
+			void* m_instance = nullptr;
+			size_t m_id = 0;
+			//entries with a different generation than the set are vacant
+			uint32_t m_generation = 0;
+		};
+		std::vector<Entry> m_entries;
+		size_t m_size = 0;
+		uint32_t m_generation = 1;
+	public:
+		void clear() noexcept
+		{
+			m_size = 0;
+			if (++m_generation == 0)
+			{
+				for (auto& entry : m_entries)
+					entry.m_generation = 0;
+				m_generation = 1;
+			}
+		}
+
+		//returns true if the pair wasn't part of the set yet
+		bool insert(void* instance, size_t id)
+		{
+			if ((m_size + 1) * 2 > m_entries.size())
+				grow();
+			const size_t mask = m_entries.size() - 1;
+			for (size_t i = hash(instance, id) & mask;; i = (i + 1) & mask)
+			{
+				auto& entry = m_entries[i];
+				if (entry.m_generation != m_generation)
+				{
+					entry = { instance, id, m_generation };
+					++m_size;
+					return true;
+				}
+				if (entry.m_instance == instance && entry.m_id == id)
+					return false;
+			}
+		}
+
+	private:
+		static size_t hash(void* instance, size_t id) noexcept
+		{
+			size_t h = reinterpret_cast<uintptr_t>(instance) ^ (id * static_cast<size_t>(0x9E3779B97F4A7C15ull));
+			h ^= h >> 16;
+			h *= static_cast<size_t>(0x85EBCA6Bu);
+			h ^= h >> 13;
+			return h;
+		}
+
+		void grow()
 		{
-			for (auto& [typeID, slot] : m_slots)
-				slot(args...);
+			auto oldEntries = std::move(m_entries);
+			m_entries.assign(std::max<size_t>(16, oldEntries.size() * 2), Entry{});
+			m_size = 0;
+			for (const auto& entry : oldEntries)
+			{
+				if (entry.m_generation == m_generation)
+					insert(entry.m_instance, entry.m_id);
+			}
 		}
 	};
 
@@ -95,16 +271,18 @@ namespace ps
 		{
 			using PMF = PMF_traits<pmfT>;
 			size_t hashVal = std::hash<std::type_index>{}(std::type_index(typeid(pmfT)));
+			if (isConnected(hashVal))
+				return hashVal;
 			if constexpr (std::is_same_v<T, void>)
 			{
-				m_slots.try_emplace(hashVal, [func](void* inst, const void*)
+				addSlot(hashVal, true, [func](void* inst, const void*)
 					{
 						(static_cast<typename PMF::class_type*>(inst)->*func)();
 					});
 			}
 			else
 			{
-				m_slots.try_emplace(hashVal, [func](void* inst, const void* valPtr)
+				addSlot(hashVal, true, [func](void* inst, const void* valPtr)
 					{
 						(static_cast<typename PMF::class_type*>(inst)->*func)(*static_cast<const T*>(valPtr));
 					});
@@ -113,14 +291,19 @@ namespace ps
 			return hashVal;
 		}
 
-        void emitUnique(void* inst, const void* value, std::unordered_set<size_t>& alreadyInvoked)
-        {
-            for (auto& [typeID, slot] : m_slots)
-                if (auto it = alreadyInvoked.find(typeID); it == alreadyInvoked.end())
-                {
-                    slot(inst, value);
-                    alreadyInvoked.emplace_hint(it, typeID);
-                }
-        }
+		//the same member function of the same instance is only invoked once
+		void emitUnique(void* inst, const void* value, InvocationSet& alreadyInvoked)
+		{
+			++m_emitDepth;
+			for (size_t i = 0, size = m_slots.size(); i < size; ++i)
+			{
+				auto& slot = m_slots[i];
+				if (slot.m_id == s_disconnected)
+					continue;
+				if (!slot.m_unique || alreadyInvoked.insert(inst, slot.m_id))
+					slot.m_func(inst, value);
+			}
+			endEmit();
+		}
 	};
 }
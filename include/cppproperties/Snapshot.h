@@ -0,0 +1,465 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        SnapshotCodec
+	//#
+	//############################################################################
+
+	//encodes / decodes the value of a property for a snapshot
+	//specialize it for your own types, or pass a codec type to SnapshotSchema::add
+	template<typename T, typename = void>
+	struct SnapshotCodec;
+
+	template<typename T>
+	struct SnapshotCodec<T, std::enable_if_t<std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>>>
+	{
+		static void encode(const T& value, std::vector<char>& out)
+		{
+			const auto* bytes = reinterpret_cast<const char*>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(T));
+		}
+		static T decode(const char* data, size_t size)
+		{
+			if (size != sizeof(T))
+				throw std::runtime_error("SnapshotCodec: the size of the value doesn't match its type");
+			T value;
+			std::memcpy(&value, data, sizeof(T));
+			return value;
+		}
+	};
+
+	template<>
+	struct SnapshotCodec<std::string>
+	{
+		static void encode(const std::string& value, std::vector<char>& out)
+		{
+			out.insert(out.end(), value.begin(), value.end());
+		}
+		static std::string decode(const char* data, size_t size)
+		{
+			return std::string(data, size);
+		}
+	};
+
+	template<typename T>
+	struct SnapshotCodec<std::vector<T>, std::enable_if_t<std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>>>
+	{
+		static void encode(const std::vector<T>& value, std::vector<char>& out)
+		{
+			const auto* bytes = reinterpret_cast<const char*>(value.data());
+			out.insert(out.end(), bytes, bytes + value.size() * sizeof(T));
+		}
+		static std::vector<T> decode(const char* data, size_t size)
+		{
+			if (size % sizeof(T) != 0)
+				throw std::runtime_error("SnapshotCodec: the size of the value doesn't match its type");
+			std::vector<T> value(size / sizeof(T));
+			std::memcpy(value.data(), data, size);
+			return value;
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#                        MappedFile
+	//#
+	//############################################################################
+
+	//a read only view of a whole file, it's memory mapped where that's supported
+	class MappedFile
+	{
+		const char* m_data = nullptr;
+		size_t m_size = 0;
+#ifdef _WIN32
+		std::vector<char> m_buffer;
+#endif
+	public:
+		explicit MappedFile(const std::string& path)
+		{
+#ifdef _WIN32
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+				throw std::runtime_error("MappedFile: can't open " + path);
+			m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			m_data = m_buffer.data();
+			m_size = m_buffer.size();
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+				throw std::runtime_error("MappedFile: can't open " + path);
+			struct stat fileStat{};
+			if (::fstat(fd, &fileStat) != 0)
+			{
+				::close(fd);
+				throw std::runtime_error("MappedFile: can't read the size of " + path);
+			}
+			m_size = static_cast<size_t>(fileStat.st_size);
+			if (m_size)
+			{
+				void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (mapping == MAP_FAILED)
+				{
+					::close(fd);
+					throw std::runtime_error("MappedFile: can't map " + path);
+				}
+				m_data = static_cast<const char*>(mapping);
+			}
+			//the mapping stays valid after the file is closed
+			::close(fd);
+#endif
+		}
+		~MappedFile()
+		{
+#ifndef _WIN32
+			if (m_data)
+				::munmap(const_cast<char*>(m_data), m_size);
+#endif
+		}
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		[[nodiscard]] const char* data() const noexcept
+		{
+			return m_data;
+		}
+		[[nodiscard]] size_t size() const noexcept
+		{
+			return m_size;
+		}
+	};
+
+	//###########################################################################
+	//#
+	//#                        SnapshotSchema
+	//#
+	//############################################################################
+
+	//saves and loads the properties of a container hierarchy in a binary format
+	//only the properties of the PDs that were added to the schema are saved, they are identified by the name
+	//of the PD, so the PDs need unique names (the ids of the PDs can differ between the runs of a program)
+	//values of PDs that are unknown when the snapshot is loaded are skipped
+	//proxy properties aren't saved, since they are computed from the other properties
+	//the children are loaded as ContainerT, the dynamic type of a child container isn't saved
+	//the format uses the byte order of the machine, it's meant for caches and fast startups, not for exchange
+	//layout: header, descriptor names, then the containers in pre order:
+	//[property count][properties: descriptor index, size, value][child count][children]
+	template<typename ContainerT = PropertyContainer>
+	class SnapshotSchema
+	{
+		static constexpr char s_magic[4] = { 'C', 'P', 'P', 'S' };
+		static constexpr uint32_t s_version = 1;
+
+		struct Entry
+		{
+			const PropertyDescriptorBase* m_pd = nullptr;
+			void(*m_encode)(const void* value, std::vector<char>& out) = nullptr;
+			void(*m_load)(ContainerT& container, const PropertyDescriptorBase& pd, const char* data, size_t size) = nullptr;
+			void(*m_remove)(ContainerT& container, const PropertyDescriptorBase& pd) = nullptr;
+		};
+		std::vector<Entry> m_entries;
+		//PD id -> entry index + 1, 0 means that the PD isn't part of the schema
+		std::vector<uint32_t> m_entryById;
+		std::unordered_map<std::string_view, uint32_t> m_entryByName;
+		size_t m_maxDepth = 1024;
+
+		//encodes its deltas with the codecs of the schema
+		template<typename>
+		friend class ChangeJournal;
+
+		class Reader
+		{
+			const char* m_data;
+			const char* m_end;
+		public:
+			Reader(const char* data, size_t size) noexcept
+				: m_data(data), m_end(data + size) {}
+
+			const char* read(size_t size)
+			{
+				if (static_cast<size_t>(m_end - m_data) < size)
+					throw std::runtime_error("SnapshotSchema: the snapshot is truncated");
+				return std::exchange(m_data, m_data + size);
+			}
+			uint32_t readUInt()
+			{
+				uint32_t value;
+				std::memcpy(&value, read(sizeof(value)), sizeof(value));
+				return value;
+			}
+			bool atEnd() const noexcept
+			{
+				return m_data == m_end;
+			}
+			size_t remaining() const noexcept
+			{
+				return static_cast<size_t>(m_end - m_data);
+			}
+		};
+
+		static void writeUInt(std::vector<char>& out, uint32_t value)
+		{
+			const auto* bytes = reinterpret_cast<const char*>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(value));
+		}
+		static void patchUInt(std::vector<char>& out, size_t offset, uint32_t value)
+		{
+			std::memcpy(out.data() + offset, &value, sizeof(value));
+		}
+
+		const Entry* findEntry(const PropertyDescriptorBase& pd) const noexcept
+		{
+			const auto id = pd.getId();
+			return id < m_entryById.size() && m_entryById[id] ? &m_entries[m_entryById[id] - 1] : nullptr;
+		}
+
+		template<typename SourceT>
+		void saveContainer(const SourceT& container, std::vector<char>& out) const
+		{
+			const size_t propertyCountOffset = out.size();
+			writeUInt(out, 0);
+			uint32_t propertyCount = 0;
+			container.forEachProperty([&](const PropertyDescriptorBase& pd, const void* value) {
+				const Entry* entry = findEntry(pd);
+				if (!entry)
+					return;
+				writeUInt(out, static_cast<uint32_t>(entry - m_entries.data()));
+				const size_t sizeOffset = out.size();
+				writeUInt(out, 0);
+				entry->m_encode(value, out);
+				patchUInt(out, sizeOffset, static_cast<uint32_t>(out.size() - sizeOffset - sizeof(uint32_t)));
+				++propertyCount;
+			});
+			patchUInt(out, propertyCountOffset, propertyCount);
+
+			const size_t childCountOffset = out.size();
+			writeUInt(out, 0);
+			uint32_t childCount = 0;
+			for (auto it = container.cbegin(); it != container.cend(); ++it)
+			{
+				if ((*it)->isProxyProperty())
+					continue;
+				saveContainer(**it, out);
+				++childCount;
+			}
+			patchUInt(out, childCountOffset, childCount);
+		}
+
+		//a property value of the snapshot, it points into the loaded data
+		struct LoadedValue
+		{
+			const Entry* m_entry;
+			const char* m_data;
+			uint32_t m_size;
+		};
+
+		static void readProperties(Reader& reader, const std::vector<const Entry*>& entries, std::vector<LoadedValue>& values)
+		{
+			values.clear();
+			const uint32_t propertyCount = reader.readUInt();
+			for (uint32_t i = 0; i < propertyCount; ++i)
+			{
+				const uint32_t descriptorIndex = reader.readUInt();
+				if (descriptorIndex >= entries.size())
+					throw std::runtime_error("SnapshotSchema: invalid descriptor index");
+				const uint32_t size = reader.readUInt();
+				const char* value = reader.read(size);
+				if (const Entry* entry = entries[descriptorIndex])
+					values.push_back({ entry, value, size });
+			}
+		}
+
+		static void setProperties(const std::vector<LoadedValue>& values, ContainerT& container)
+		{
+			for (const auto& value : values)
+				value.m_entry->m_load(container, *value.m_entry->m_pd, value.m_data, value.m_size);
+		}
+
+		struct LoadedHierarchy
+		{
+			//the values are decoded into m_root as well, a value that can't be decoded throws before the root is changed
+			std::vector<LoadedValue> m_rootValues;
+			std::unique_ptr<ContainerT> m_root;
+			std::vector<std::unique_ptr<ContainerT>> m_rootChildren;
+		};
+
+		//the containers are loaded with an explicit stack, the nesting depth of the snapshot can't overflow the call stack
+		//the hierarchy is built aside, so a malformed snapshot leaves the hierarchy it's loaded into untouched
+		LoadedHierarchy readHierarchy(Reader& reader, const std::vector<const Entry*>& entries) const
+		{
+			struct Level
+			{
+				std::unique_ptr<ContainerT> m_container;
+				uint32_t m_remainingChildren;
+			};
+			LoadedHierarchy loaded;
+			readProperties(reader, entries, loaded.m_rootValues);
+			auto loadedRoot = std::make_unique<ContainerT>();
+			setProperties(loaded.m_rootValues, *loadedRoot);
+			std::vector<LoadedValue> values;
+			std::vector<Level> stack;
+			stack.push_back({ std::move(loadedRoot), reader.readUInt() });
+			while (true)
+			{
+				if (stack.back().m_remainingChildren == 0)
+				{
+					if (stack.size() == 1)
+						break;
+					//the child is filled before it's added, so no signals have to be rerouted
+					auto child = std::move(stack.back().m_container);
+					stack.pop_back();
+					if (stack.size() == 1)
+						loaded.m_rootChildren.push_back(std::move(child));
+					else
+						stack.back().m_container->addChildContainer(std::move(child));
+					continue;
+				}
+				--stack.back().m_remainingChildren;
+				if (stack.size() > m_maxDepth)
+					throw std::runtime_error("SnapshotSchema: the snapshot is nested too deeply");
+				auto child = std::make_unique<ContainerT>();
+				readProperties(reader, entries, values);
+				setProperties(values, *child);
+				const uint32_t childCount = reader.readUInt();
+				stack.push_back({ std::move(child), childCount });
+			}
+			loaded.m_root = std::move(stack.back().m_container);
+			return loaded;
+		}
+
+		//sets the loaded values at the root and adds the loaded children to it
+		static void spliceHierarchy(LoadedHierarchy& loaded, ContainerT& root)
+		{
+			setProperties(loaded.m_rootValues, root);
+			for (auto& child : loaded.m_rootChildren)
+				root.addChildContainer(std::move(child));
+		}
+
+		//the loaded root with its children, e.g. to add it as a new child
+		static std::unique_ptr<ContainerT> takeHierarchy(LoadedHierarchy& loaded)
+		{
+			for (auto& child : loaded.m_rootChildren)
+				loaded.m_root->addChildContainer(std::move(child));
+			return std::move(loaded.m_root);
+		}
+
+	public:
+		//adds a PD to the schema, the value is encoded with the codec
+		template<typename T, typename CodecT = SnapshotCodec<T>>
+		void add(const PropertyDescriptor<T>& pd)
+		{
+			assert(!pd.getName().empty() && "only PDs with a name can be part of a snapshot");
+			assert(!m_entryByName.count(pd.getName()) && "the names of the PDs have to be unique");
+			Entry entry;
+			entry.m_pd = &pd;
+			entry.m_encode = +[](const void* value, std::vector<char>& out) {
+				CodecT::encode(*static_cast<const T*>(value), out);
+			};
+			entry.m_load = +[](ContainerT& container, const PropertyDescriptorBase& pd, const char* data, size_t size) {
+				container.setProperty(static_cast<const PropertyDescriptor<T>&>(pd), CodecT::decode(data, size));
+			};
+			entry.m_remove = +[](ContainerT& container, const PropertyDescriptorBase& pd) {
+				container.removeProperty(static_cast<const PropertyDescriptor<T>&>(pd));
+			};
+			m_entries.push_back(entry);
+			const auto index = static_cast<uint32_t>(m_entries.size());
+			if (pd.getId() >= m_entryById.size())
+				m_entryById.resize(static_cast<size_t>(pd.getId()) + 1, 0);
+			m_entryById[pd.getId()] = index;
+			m_entryByName.emplace(pd.getName(), index);
+		}
+
+		//snapshots with containers nested deeper than this are rejected when they are loaded
+		//(a hierarchy that deep would be destroyed, copied and emitted recursively)
+		void setMaxDepth(size_t maxDepth) noexcept
+		{
+			m_maxDepth = maxDepth;
+		}
+
+		//appends the snapshot of the container and its children to out
+		void save(const ContainerT& root, std::vector<char>& out) const
+		{
+			out.insert(out.end(), std::begin(s_magic), std::end(s_magic));
+			writeUInt(out, s_version);
+			writeUInt(out, static_cast<uint32_t>(m_entries.size()));
+			for (const auto& entry : m_entries)
+			{
+				const auto& name = entry.m_pd->getName();
+				writeUInt(out, static_cast<uint32_t>(name.size()));
+				out.insert(out.end(), name.begin(), name.end());
+			}
+			saveContainer(root, out);
+		}
+
+		void saveFile(const ContainerT& root, const std::string& path) const
+		{
+			std::vector<char> snapshot;
+			save(root, snapshot);
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size())))
+				throw std::runtime_error("SnapshotSchema: can't write " + path);
+		}
+
+		//sets the saved properties at the root and adds the saved children to it
+		//throws std::runtime_error if the snapshot is malformed, the root is only changed if the whole snapshot could be loaded
+		void load(const char* data, size_t size, ContainerT& root) const
+		{
+			Reader reader(data, size);
+			if (std::memcmp(reader.read(sizeof(s_magic)), s_magic, sizeof(s_magic)) != 0)
+				throw std::runtime_error("SnapshotSchema: the data isn't a snapshot");
+			if (reader.readUInt() != s_version)
+				throw std::runtime_error("SnapshotSchema: unsupported snapshot version");
+			//the descriptors are resolved by name once, the values refer to them by index
+			const uint32_t descriptorCount = reader.readUInt();
+			std::vector<const Entry*> entries;
+			//the count isn't trusted, every descriptor needs at least the size of its name
+			entries.reserve(std::min<size_t>(descriptorCount, reader.remaining() / sizeof(uint32_t)));
+			for (uint32_t i = 0; i < descriptorCount; ++i)
+			{
+				const uint32_t nameSize = reader.readUInt();
+				const std::string_view name(reader.read(nameSize), nameSize);
+				auto it = m_entryByName.find(name);
+				entries.push_back(it != m_entryByName.end() ? &m_entries[it->second - 1] : nullptr);
+			}
+			auto loaded = readHierarchy(reader, entries);
+			if (!reader.atEnd())
+				throw std::runtime_error("SnapshotSchema: unexpected data at the end of the snapshot");
+			spliceHierarchy(loaded, root);
+		}
+
+		//the file is memory mapped while it's loaded
+		void loadFile(const std::string& path, ContainerT& root) const
+		{
+			MappedFile file(path);
+			load(file.data(), file.size(), root);
+		}
+	};
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "PropertySystem_forward.h"
+#include "PropertyContainer.h"
+
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        StaticPropertyContainer
+	//#
+	//############################################################################
+
+	//a property container for a fixed set of PDs that is known at compile time, e.g.
+	//class Entity : public ps::StaticPropertyContainer<PositionPD, VelocityPD> {...};
+	//the properties of these PDs are members of the container, so get<PositionPD>() is a direct member access
+	//and getProperty(PositionPD) doesn't need a lookup either (as long as the PD is known when it's inlined)
+	//the container is still a normal node of a hierarchy: the static properties are visible to the children,
+	//they can be observed, changed via changeProperty and are emitted like any other property,
+	//any other PD can still be set dynamically
+	//the static properties are always owned by this container, so they can't be removed or replaced by a proxy property,
+	//neither via this interface nor via the PropertyContainer interface (e.g. through container[0] of the parent)
+	template<const auto& ... PDs>
+	class StaticPropertyContainer : public PropertyContainer
+	{
+		template<const auto& PD>
+		using ValueT = typename std::decay_t<decltype(PD)>::value_type;
+
+		std::tuple<Property<ValueT<PDs>>...> m_staticProperties;
+
+		template<const auto& PD, size_t... Is>
+		static constexpr size_t indexOfInternal(std::index_sequence<Is...>) noexcept
+		{
+			size_t index = sizeof...(PDs);
+			(void)((static_cast<const void*>(&PD) == static_cast<const void*>(&PDs) ? (index = Is, true) : false) || ...);
+			return index;
+		}
+		template<const auto& PD>
+		static constexpr size_t s_indexOf = indexOfInternal<PD>(std::index_sequence_for<decltype(PDs)...>{});
+
+	public:
+		//the static properties start with the default value of their PD
+		StaticPropertyContainer()
+			: m_staticProperties(PDs.getDefaultValue()...)
+		{
+			registerStaticProperties(std::index_sequence_for<decltype(PDs)...>{});
+		}
+		StaticPropertyContainer(const StaticPropertyContainer& other)
+			: StaticPropertyContainer(other, std::index_sequence_for<decltype(PDs)...>{}) {}
+		StaticPropertyContainer& operator=(const StaticPropertyContainer&) = delete;
+
+		template<const auto& PD>
+		[[nodiscard]] const ValueT<PD>& get() const noexcept
+		{
+			static_assert(s_indexOf<PD> < sizeof...(PDs), "The PD isn't a static property of this container.");
+			return std::get<s_indexOf<PD>>(m_staticProperties).Property<ValueT<PD>>::get();
+		}
+
+		template<const auto& PD, typename U>
+		void set(U&& value)
+		{
+			static_assert(s_indexOf<PD> < sizeof...(PDs), "The PD isn't a static property of this container.");
+			std::get<s_indexOf<PD>>(m_staticProperties).set(std::forward<U>(value));
+		}
+
+		//the same interface as PropertyContainer, the static PDs are resolved without a lookup
+		template<typename T>
+		[[nodiscard]] const Property<T>& getProperty(const PropertyDescriptor<T>& pd) const
+		{
+			if (const auto* property = findStaticProperty(pd, std::index_sequence_for<decltype(PDs)...>{}))
+				return *property;
+			return PropertyContainer::getProperty(pd);
+		}
+		template<typename T>
+		[[nodiscard]] const Property<T>& operator [] (const PropertyDescriptor<T>& pd) const
+		{
+			return getProperty(pd);
+		}
+
+		template<typename T, typename U>
+		void setProperty(const PropertyDescriptor<T>& pd, U&& value)
+		{
+			if (auto* property = findStaticProperty(pd, std::index_sequence_for<decltype(PDs)...>{}))
+			{
+				if constexpr (std::is_convertible_v<std::decay_t<U>, T>)
+					property->set(std::forward<U>(value));
+				else
+					assert(false && "a static property can't be replaced by a proxy property");
+				return;
+			}
+			PropertyContainer::setProperty(pd, std::forward<U>(value));
+		}
+
+		template<typename T, typename U>
+		void changeProperty(const PropertyDescriptor<T>& pd, U&& value)
+		{
+			if (auto* property = findStaticProperty(pd, std::index_sequence_for<decltype(PDs)...>{}))
+				property->set(std::forward<U>(value));
+			else
+				PropertyContainer::changeProperty(pd, std::forward<U>(value));
+		}
+
+		template<typename T>
+		void removeProperty(const PropertyDescriptor<T>& pd)
+		{
+			if (findStaticProperty(pd, std::index_sequence_for<decltype(PDs)...>{}))
+			{
+				assert(false && "a static property can't be removed");
+				return;
+			}
+			PropertyContainer::removeProperty(pd);
+		}
+
+	private:
+		//the PropertyContainer copies the static properties as dynamic ones, they are replaced by the members afterwards
+		template<size_t... Is>
+		StaticPropertyContainer(const StaticPropertyContainer& other, std::index_sequence<Is...> is)
+			: PropertyContainer(other)
+			, m_staticProperties(std::get<Is>(other.m_staticProperties).get()...)
+		{
+			registerStaticProperties(is);
+		}
+
+		template<typename T, size_t... Is>
+		Property<T>* findStaticProperty(const PropertyDescriptor<T>& pd, std::index_sequence<Is...>) const noexcept
+		{
+			Property<T>* property = nullptr;
+			(void)((findStaticPropertyInternal<Is>(pd, property)) || ...);
+			return property;
+		}
+		template<size_t I, typename T>
+		bool findStaticPropertyInternal(const PropertyDescriptor<T>& pd, Property<T>*& property) const noexcept
+		{
+			if constexpr (std::is_same_v<std::tuple_element_t<I, decltype(m_staticProperties)>, Property<T>>)
+			{
+				if (static_cast<const void*>(&pd) == static_cast<const void*>(&std::get<I>(std::forward_as_tuple(PDs...))))
+				{
+					property = const_cast<Property<T>*>(&std::get<I>(m_staticProperties));
+					return true;
+				}
+			}
+			return false;
+		}
+
+		//the property data of the static PDs refers to the members, without owning them
+		template<size_t... Is>
+		void registerStaticProperties(std::index_sequence<Is...>)
+		{
+			(registerStaticProperty(std::get<Is>(std::forward_as_tuple(PDs...)), std::get<Is>(m_staticProperties)), ...);
+		}
+		template<typename T>
+		void registerStaticProperty(const PropertyDescriptor<T>& pd, Property<T>& property)
+		{
+			auto& propertyData = m_propertyData[&pd];
+			propertyData.init(std::shared_ptr<Property<T>>(std::shared_ptr<Property<T>>(), &property), this, &pd);
+			propertyData.m_isStaticProperty = true;
+		}
+	};
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include "InplaceFunction.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ps
+{
+	//###########################################################################
+	//#
+	//#                        ThreadPool
+	//#
+	//############################################################################
+
+	//small work stealing thread pool, used by PropertyContainerBase::emit(ThreadPool&)
+	//every worker has its own task queue, it takes tasks from the back of its own queue
+	//and steals from the front of the other queues when it runs out of work
+	//a thread that waits for tasks (see parallelFor) helps executing tasks instead of blocking,
+	//so tasks can submit and wait for further tasks without deadlocking
+	class ThreadPool
+	{
+		using TaskT = InplaceFunction<void()>;
+
+		struct TaskQueue
+		{
+			std::mutex m_mutex;
+			std::deque<TaskT> m_tasks;
+		};
+
+		std::vector<std::unique_ptr<TaskQueue>> m_queues;
+		std::vector<std::thread> m_threads;
+		std::mutex m_sleepMutex;
+		std::condition_variable m_wakeUp;
+		std::atomic<size_t> m_pendingTasks{ 0 };
+		std::atomic<size_t> m_nextQueue{ 0 };
+		bool m_stop = false;
+
+		//the index of the queue of the current thread, external threads don't have a queue
+		static size_t& currentQueueIndex() noexcept
+		{
+			thread_local size_t index = static_cast<size_t>(-1);
+			return index;
+		}
+
+	public:
+		explicit ThreadPool(size_t threadCount = std::max(1u, std::thread::hardware_concurrency()))
+		{
+			threadCount = std::max<size_t>(threadCount, 1);
+			for (size_t i = 0; i < threadCount; ++i)
+				m_queues.push_back(std::make_unique<TaskQueue>());
+			for (size_t i = 0; i < threadCount; ++i)
+				m_threads.emplace_back([this, i] { workerLoop(i); });
+		}
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+		~ThreadPool()
+		{
+			{
+				std::lock_guard lock(m_sleepMutex);
+				m_stop = true;
+			}
+			m_wakeUp.notify_all();
+			for (auto& thread : m_threads)
+				thread.join();
+		}
+
+		size_t size() const noexcept
+		{
+			return m_threads.size();
+		}
+
+		template<typename FuncT>
+		void submit(FuncT&& func)
+		{
+			size_t queueIndex = currentQueueIndex();
+			if (queueIndex >= m_queues.size())
+				queueIndex = m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+			{
+				//the counter is incremented before the task is published, otherwise a stealing worker could decrement it first
+				//incrementing under the lock guarantees that a worker going to sleep sees the new task
+				std::lock_guard lock(m_sleepMutex);
+				m_pendingTasks.fetch_add(1, std::memory_order_relaxed);
+			}
+			try
+			{
+				auto& queue = *m_queues[queueIndex];
+				std::lock_guard lock(queue.m_mutex);
+				queue.m_tasks.emplace_back(std::forward<FuncT>(func));
+			}
+			catch (...)
+			{
+				m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+				throw;
+			}
+			m_wakeUp.notify_one();
+		}
+
+		//invokes func(i) for all i in [0, count) and returns once all of them are done
+		//the calling thread takes part in the execution
+		//if func throws, the remaining calls still run and the first exception is rethrown on the calling thread
+		template<typename FuncT>
+		void parallelFor(size_t count, FuncT&& func)
+		{
+			struct State
+			{
+				std::atomic<size_t> m_remaining;
+				std::atomic<bool> m_hasFailed{ false };
+				std::exception_ptr m_exception;
+			} state{ count };
+			size_t submitted = 0;
+			try
+			{
+				for (; submitted < count; ++submitted)
+				{
+					submit([&func, &state, i = submitted] {
+						try
+						{
+							func(i);
+						}
+						catch (...)
+						{
+							if (!state.m_hasFailed.exchange(true, std::memory_order_relaxed))
+								state.m_exception = std::current_exception();
+						}
+						state.m_remaining.fetch_sub(1, std::memory_order_release);
+					});
+				}
+			}
+			catch (...)
+			{
+				//the submitted tasks refer to the state, they have to be done before it goes out of scope
+				state.m_remaining.fetch_sub(count - submitted, std::memory_order_release);
+				waitFor(state.m_remaining);
+				throw;
+			}
+			waitFor(state.m_remaining);
+			if (state.m_exception)
+				std::rethrow_exception(state.m_exception);
+		}
+
+		//runs one pending task on the calling thread, returns false if there was none
+		bool runPendingTask()
+		{
+			TaskT task;
+			if (!popTask(currentQueueIndex(), task))
+				return false;
+			task();
+			return true;
+		}
+
+	private:
+		void waitFor(const std::atomic<size_t>& remaining)
+		{
+			while (remaining.load(std::memory_order_acquire) != 0)
+			{
+				if (!runPendingTask())
+					std::this_thread::yield();
+			}
+		}
+
+		bool popTask(size_t ownIndex, TaskT& task)
+		{
+			if (ownIndex < m_queues.size())
+			{
+				auto& queue = *m_queues[ownIndex];
+				std::lock_guard lock(queue.m_mutex);
+				if (!queue.m_tasks.empty())
+				{
+					task = std::move(queue.m_tasks.back());
+					queue.m_tasks.pop_back();
+					m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			//steal the oldest task of one of the other queues
+			const size_t start = ownIndex < m_queues.size() ? ownIndex + 1 : 0;
+			for (size_t i = 0; i < m_queues.size(); ++i)
+			{
+				auto& queue = *m_queues[(start + i) % m_queues.size()];
+				std::lock_guard lock(queue.m_mutex);
+				if (!queue.m_tasks.empty())
+				{
+					task = std::move(queue.m_tasks.front());
+					queue.m_tasks.pop_front();
+					m_pendingTasks.fetch_sub(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void workerLoop(size_t index)
+		{
+			currentQueueIndex() = index;
+			while (true)
+			{
+				if (runPendingTask())
+					continue;
+				std::unique_lock lock(m_sleepMutex);
+				m_wakeUp.wait(lock, [this] { return m_stop || m_pendingTasks.load(std::memory_order_relaxed) != 0; });
+				if (m_stop)
+					return;
+			}
+		}
+	};
+}
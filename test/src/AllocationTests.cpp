@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <cppproperties/PropertyContainer.h>
+#include <cppproperties/ProxyProperty.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+//###########################################################################
+//#
+//#                    counting allocator
+//#
+//###########################################################################
+
+//the global allocation functions are replaced for the whole test executable,
+//they only count the allocations and forward to malloc / free
+namespace
+{
+	std::atomic<size_t> s_allocationCount{ 0 };
+
+	void* countedAllocate(std::size_t size, std::size_t alignment = 0)
+	{
+		s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+		if (size == 0)
+			size = 1;
+		void* ptr = nullptr;
+		if (alignment > alignof(std::max_align_t))
+		{
+			if (posix_memalign(&ptr, alignment, size) != 0)
+				ptr = nullptr;
+		}
+		else
+			ptr = std::malloc(size);
+		if (!ptr)
+			throw std::bad_alloc();
+		return ptr;
+	}
+}
+
+void* operator new(std::size_t size) { return countedAllocate(size); }
+void* operator new[](std::size_t size) { return countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return countedAllocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return countedAllocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace
+{
+	ps::PropertyDescriptor<int> IntPD(0);
+	ps::PropertyDescriptor<int> OtherIntPD(0);
+	ps::PropertyDescriptor<int> SumPD(0);
+
+	class ObserverContainer : public ps::PropertyContainer
+	{
+	public:
+		void onIntChanged(int value)
+		{
+			m_value += value;
+		}
+		int m_value = 0;
+	};
+
+	//a hierarchy with lambdas, member functions and a proxy property that is recomputed every frame
+	struct Scene
+	{
+		ps::PropertyContainer m_root;
+		int m_lambdaSink = 0;
+		std::function<int(int, int)> m_sum = [](int a, int b) { return a + b; };
+
+		Scene()
+		{
+			m_root.setProperty(IntPD, 0);
+			m_root.setProperty(OtherIntPD, 0);
+			for (int i = 0; i < 32; ++i)
+			{
+				auto& child = m_root.addChildContainer<ObserverContainer>();
+				child.connect(IntPD, &ObserverContainer::onIntChanged);
+				child.connect(IntPD, [this](int value) { m_lambdaSink += value; });
+				auto& grandChild = child.addChildContainer<ObserverContainer>();
+				grandChild.connect(OtherIntPD, &ObserverContainer::onIntChanged);
+			}
+			auto& proxyChild = m_root.addChildContainer<ps::PropertyContainer>();
+			proxyChild.setProperty(SumPD, ps::make_proxy_property(m_sum, IntPD, OtherIntPD));
+			proxyChild.connect(SumPD, [this](int value) { m_lambdaSink += value; });
+		}
+
+		void frame(int value, bool ignoreDuplicateCalls)
+		{
+			m_root.changeProperty(IntPD, value);
+			m_root.changeProperty(OtherIntPD, value);
+			m_root.emit(ignoreDuplicateCalls);
+		}
+	};
+
+	size_t allocationsPerFrames(bool ignoreDuplicateCalls)
+	{
+		Scene scene;
+		int value = 0;
+		//warm up, the scratch buffers grow to their working size here
+		for (int i = 0; i < 4; ++i)
+			scene.frame(++value, ignoreDuplicateCalls);
+
+		const size_t before = s_allocationCount.load(std::memory_order_relaxed);
+		for (int i = 0; i < 16; ++i)
+			scene.frame(++value, ignoreDuplicateCalls);
+		return s_allocationCount.load(std::memory_order_relaxed) - before;
+	}
+}
+
+//###########################################################################
+//#
+//#                    Allocation Tests
+//#
+//###########################################################################
+
+TEST(AllocationTest, emit_steadyStateEliminateDuplicates_noAllocations)
+{
+	ASSERT_EQ(allocationsPerFrames(true), 0u);
+}
+
+TEST(AllocationTest, emit_steadyStateWithDuplicates_noAllocations)
+{
+	ASSERT_EQ(allocationsPerFrames(false), 0u);
+}
+
+namespace
+{
+	//forwards to the heap and keeps track of the bytes that haven't been returned yet
+	class CountingResource : public std::pmr::memory_resource
+	{
+	public:
+		size_t m_allocationCount = 0;
+		size_t m_outstandingBytes = 0;
+	private:
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override
+		{
+			++m_allocationCount;
+			m_outstandingBytes += bytes;
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+		{
+			m_outstandingBytes -= bytes;
+			std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+		}
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return this == &other;
+		}
+	};
+}
+
+TEST(AllocationTest, memoryResource_childrenAndProperties_allocatedFromResource)
+{
+	CountingResource resource;
+	{
+		ps::PropertyContainer root(&resource);
+		root.setProperty(IntPD, 1);
+		auto& child = root.addChildContainer<ObserverContainer>();
+		auto& grandChild = child.addChildContainer(std::make_unique<ps::PropertyContainer>());
+		ASSERT_EQ(child.getMemoryResource(), &resource);
+		ASSERT_EQ(grandChild.getMemoryResource(), &resource);
+
+		const size_t before = resource.m_allocationCount;
+		grandChild.setProperty(OtherIntPD, 2);
+		grandChild.connectToVar(IntPD, child.m_value);
+		child.setProperty(SumPD, ps::make_proxy_property([](int a, int b) { return a + b; }, IntPD, OtherIntPD));
+		child.setProperty(IntPD, 3);
+		child.removeProperty(IntPD);
+		root.emit();
+		ASSERT_GT(resource.m_allocationCount, before);
+		ASSERT_GT(resource.m_outstandingBytes, 0u);
+	}
+	//everything that was allocated from the resource was returned to it
+	ASSERT_EQ(resource.m_outstandingBytes, 0u);
+}
+
+TEST(AllocationTest, memoryResource_reparentedToOtherResource_keepsOwnResource)
+{
+	CountingResource resourceA;
+	CountingResource resourceB;
+	ps::PropertyContainer rootA(&resourceA);
+	ps::PropertyContainer rootB(&resourceB);
+	auto& child = rootA.addChildContainer<ps::PropertyContainer>(&resourceA);
+	auto& inheriting = rootA.addChildContainer<ps::PropertyContainer>();
+
+	rootA.reparent(child, rootB);
+	rootA.reparent(inheriting, rootB);
+
+	ASSERT_EQ(child.getMemoryResource(), &resourceA);
+	ASSERT_EQ(inheriting.getMemoryResource(), &resourceB);
+}
+
+namespace
+{
+	ps::PropertyDescriptor<double> DoublePD(0.);
+	ps::PropertyDescriptor<std::array<double, 8>> MatrixPD(std::array<double, 8>{});
+
+	template<typename T>
+	size_t allocationsOfSetProperty(const ps::PropertyDescriptor<T>& pd)
+	{
+		ps::PropertyContainer root;
+		//the property data and the scratch buffers already exist
+		root.setProperty(pd, T{});
+		root.removeProperty(pd);
+		root.emit();
+		const size_t before = s_allocationCount.load(std::memory_order_relaxed);
+		root.setProperty(pd, T{});
+		return s_allocationCount.load(std::memory_order_relaxed) - before;
+	}
+}
+
+TEST(AllocationTest, setProperty_smallValue_storedInline)
+{
+	//small values are stored in the property data, large ones need a separate allocation
+	ASSERT_EQ(allocationsOfSetProperty(DoublePD) + 1, allocationsOfSetProperty(MatrixPD));
+}
@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include <cppproperties/ChangeJournal.h>
+#include <cppproperties/ProxyProperty.h>
+
+#include <string>
+#include <vector>
+
+//###########################################################################
+//#
+//#                    ChangeJournal Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	ps::PropertyDescriptor<int> HealthPD(100, "journal.health");
+	ps::PropertyDescriptor<std::string> TagPD("", "journal.tag");
+	ps::PropertyDescriptor<int> DoubledHealthPD(0, "journal.doubledHealth");
+	//not part of the schema
+	ps::PropertyDescriptor<int> LocalPD(0);
+
+	ps::SnapshotSchema<> makeSchema()
+	{
+		ps::SnapshotSchema<> schema;
+		schema.add(HealthPD);
+		schema.add(TagPD);
+		return schema;
+	}
+
+	void addChildren(ps::PropertyContainer& root)
+	{
+		auto& first = root.addChildContainer<ps::PropertyContainer>();
+		first.setProperty(DoubledHealthPD, ps::make_proxy_property([](int health) { return health * 2; }, HealthPD));
+		first.addChildContainer<ps::PropertyContainer>();
+		root.addChildContainer<ps::PropertyContainer>();
+	}
+
+	ps::PropertyContainer& child(ps::PropertyContainer& parent, size_t index)
+	{
+		size_t current = 0;
+		for (auto it = parent.cbegin(); it != parent.cend(); ++it)
+		{
+			if (!(*it)->isProxyProperty() && current++ == index)
+				return static_cast<ps::PropertyContainer&>(**it);
+		}
+		throw std::out_of_range("no such child");
+	}
+}
+
+TEST(ChangeJournal, applyDelta_replicaFollowsChanges)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root, replica;
+	addChildren(root);
+	addChildren(replica);
+	ps::ChangeJournal<> journal(root, schema);
+
+	int replicaHealth = 0;
+	child(child(replica, 0), 0).connect(HealthPD, [&replicaHealth](int health) { replicaHealth = health; });
+
+	child(root, 0).setProperty(HealthPD, 50);
+	child(child(root, 0), 0).setProperty(TagPD, "goblin");
+	child(root, 1).setProperty(TagPD, "chest");
+	child(root, 1).setProperty(LocalPD, 1);
+	root.emit();
+	ASSERT_FALSE(journal.empty());
+
+	std::vector<char> delta;
+	journal.takeDelta(delta);
+	EXPECT_TRUE(journal.empty());
+	ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica);
+	replica.emit();
+
+	EXPECT_EQ(child(replica, 0).getProperty(HealthPD), 50);
+	EXPECT_EQ(child(replica, 0).getProperty(DoubledHealthPD), 100);
+	EXPECT_EQ(child(child(replica, 0), 0).getProperty(TagPD), "goblin");
+	EXPECT_EQ(child(replica, 1).getProperty(TagPD), "chest");
+	EXPECT_FALSE(child(replica, 1).hasProperty(LocalPD));
+	EXPECT_EQ(replicaHealth, 50);
+
+	child(root, 0).removeProperty(HealthPD);
+	child(root, 1).setProperty(TagPD, "open chest");
+	root.emit();
+	delta.clear();
+	journal.takeDelta(delta);
+	ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica);
+	replica.emit();
+
+	EXPECT_FALSE(child(replica, 0).hasProperty(HealthPD));
+	EXPECT_EQ(child(child(replica, 0), 0).getProperty(HealthPD), 100);
+	EXPECT_EQ(child(replica, 1).getProperty(TagPD), "open chest");
+	EXPECT_EQ(replicaHealth, 100);
+}
+
+TEST(ChangeJournal, takeDelta_onlyEmittedChanges)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root;
+	ps::ChangeJournal<> journal(root, schema);
+	root.setProperty(HealthPD, 1);
+	root.setProperty(HealthPD, 2);
+	EXPECT_TRUE(journal.empty());
+	root.emit();
+	EXPECT_FALSE(journal.empty());
+
+	std::vector<char> delta;
+	journal.takeDelta(delta);
+	ps::PropertyContainer replica;
+	ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica);
+	EXPECT_EQ(replica.getProperty(HealthPD), 2);
+}
+
+TEST(ChangeJournal, applyDelta_mismatchingReplica_throws)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root, replica;
+	root.addChildContainer<ps::PropertyContainer>().setProperty(HealthPD, 1);
+	ps::ChangeJournal<> journal(root, schema);
+	child(root, 0).setProperty(HealthPD, 2);
+	root.emit();
+	std::vector<char> delta;
+	journal.takeDelta(delta);
+
+	EXPECT_THROW(ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica), std::runtime_error);
+	EXPECT_THROW(ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size() - 1, root), std::runtime_error);
+	ps::SnapshotSchema<> otherSchema;
+	otherSchema.add(HealthPD);
+	EXPECT_THROW(ps::ChangeJournal<>::applyDelta(otherSchema, delta.data(), delta.size(), root), std::runtime_error);
+}
+
+namespace
+{
+	void applyDelta(ps::ChangeJournal<>& journal, const ps::SnapshotSchema<>& schema, ps::PropertyContainer& replica)
+	{
+		std::vector<char> delta;
+		journal.takeDelta(delta);
+		ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica);
+		replica.emit();
+	}
+
+	void expectSameHierarchy(const ps::PropertyContainerBase<>& expected, const ps::PropertyContainerBase<>& actual)
+	{
+		EXPECT_EQ(expected.getProperty(HealthPD).get(), actual.getProperty(HealthPD).get());
+		EXPECT_EQ(expected.getProperty(TagPD).get(), actual.getProperty(TagPD).get());
+		size_t index = 0;
+		for (; expected.getChildContainer(index); ++index)
+		{
+			ASSERT_TRUE(actual.getChildContainer(index));
+			expectSameHierarchy(*expected.getChildContainer(index), *actual.getChildContainer(index));
+		}
+		EXPECT_FALSE(actual.getChildContainer(index));
+	}
+}
+
+TEST(ChangeJournal, applyDelta_restructuredHierarchy_replicaFollows)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root, replica;
+	for (int i = 0; i < 3; ++i)
+	{
+		root.addChildContainer<ps::PropertyContainer>().setProperty(HealthPD, i);
+		replica.addChildContainer<ps::PropertyContainer>().setProperty(HealthPD, i);
+	}
+	//only the original has a proxy property, it's stored behind the children
+	root.setProperty(DoubledHealthPD, ps::make_proxy_property([](int health) { return health * 2; }, HealthPD));
+	ps::ChangeJournal<> journal(root, schema);
+
+	//the last child takes over the position of the removed one, the change has to end up there in the replica too
+	root.removeChild(child(root, 0));
+	child(root, 0).setProperty(TagPD, "moved");
+	auto added = std::make_unique<ps::PropertyContainer>();
+	added->setProperty(TagPD, "added");
+	added->addChildContainer<ps::PropertyContainer>().setProperty(HealthPD, 42);
+	root.addChildContainer(std::move(added));
+	root.reparent(child(root, 1), child(root, 2));
+	child(child(root, 1), 0).setProperty(HealthPD, 7);
+	root.emit();
+	applyDelta(journal, schema, replica);
+	expectSameHierarchy(root, replica);
+	EXPECT_EQ(child(replica, 0).getProperty(TagPD).get(), "moved");
+	EXPECT_EQ(child(child(replica, 1), 1).getProperty(HealthPD).get(), 1);
+
+	//a subtree that is moved into another hierarchy is removed from the replica
+	ps::PropertyContainer other;
+	root.reparent(child(root, 1), other);
+	root.emit();
+	applyDelta(journal, schema, replica);
+	expectSameHierarchy(root, replica);
+}
+
+TEST(ChangeJournal, clone_notAddedToHierarchy_notRecorded)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root;
+	auto& prototype = root.addChildContainer<ps::PropertyContainer>();
+	prototype.setProperty(HealthPD, 1);
+	root.emit();
+	ps::ChangeJournal<> journal(root, schema);
+
+	//the clone still sees the parent of the prototype, but it isn't one of its children
+	auto clone = prototype.clone<ps::PropertyContainer>();
+	clone->setProperty(HealthPD, 2);
+	clone->removeProperty(HealthPD);
+	clone->setProperty(TagPD, "clone");
+	clone->emit();
+	EXPECT_TRUE(journal.empty());
+
+	ps::PropertyContainer other;
+	other.addChildContainer(std::move(clone));
+	other.emit();
+	EXPECT_TRUE(journal.empty());
+}
+
+TEST(ChangeJournal, applyDelta_replicaMissesContainer_replicaUntouched)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root, replica;
+	root.addChildContainer<ps::PropertyContainer>();
+	root.addChildContainer<ps::PropertyContainer>();
+	//the replica doesn't match the original
+	replica.addChildContainer<ps::PropertyContainer>();
+	ps::ChangeJournal<> journal(root, schema);
+	root.setProperty(HealthPD, 1);
+	child(root, 0).addChildContainer<ps::PropertyContainer>();
+	root.emit();
+	child(root, 1).setProperty(HealthPD, 2);
+	root.emit();
+	std::vector<char> delta;
+	journal.takeDelta(delta);
+
+	//the path of the last change can't be resolved, nothing of the delta is applied
+	EXPECT_THROW(ps::ChangeJournal<>::applyDelta(schema, delta.data(), delta.size(), replica), std::runtime_error);
+	EXPECT_FALSE(replica.hasProperty(HealthPD));
+	EXPECT_EQ(child(replica, 0).size(), 0u);
+}
+
+TEST(ChangeJournal, applyDelta_overrideWithUnchangedValue_replicaOwnsProperty)
+{
+	const auto schema = makeSchema();
+	ps::PropertyContainer root, replica;
+	root.addChildContainer<ps::PropertyContainer>();
+	root.addChildContainer<ps::PropertyContainer>();
+	replica.addChildContainer<ps::PropertyContainer>();
+	replica.addChildContainer<ps::PropertyContainer>();
+	ps::ChangeJournal<> journal(root, schema);
+
+	root.setProperty(HealthPD, 5);
+	//the value of the new property equals int{}, so it's never emitted
+	child(root, 0).setProperty(HealthPD, 0);
+	root.emit();
+	applyDelta(journal, schema, replica);
+	EXPECT_EQ(child(root, 0).getProperty(HealthPD).get(), 0);
+	EXPECT_EQ(child(replica, 0).getProperty(HealthPD).get(), 0);
+
+	//the override has the inherited value, the replica only notices it once the inherited value changes
+	root.setProperty(HealthPD, 7);
+	root.emit();
+	child(root, 1).setProperty(HealthPD, 7);
+	root.emit();
+	root.setProperty(HealthPD, 9);
+	root.emit();
+	applyDelta(journal, schema, replica);
+	expectSameHierarchy(root, replica);
+	EXPECT_EQ(child(replica, 1).getProperty(HealthPD).get(), 7);
+}
@@ -0,0 +1,493 @@
+#include <gtest/gtest.h>
+#include <cppproperties/ConcurrentReads.h>
+#include <cppproperties/PropertyContainer.h>
+#include <cppproperties/ProxyProperty.h>
+#include <cppproperties/ThreadPool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	ps::PropertyDescriptor<int> IntPD(0);
+	ps::PropertyDescriptor<int> LocalIntPD(0);
+	ps::PropertyDescriptor<int> OtherLocalIntPD(0);
+
+	class CountingContainer : public ps::PropertyContainer
+	{
+	public:
+		void onChanged()
+		{
+			++m_callCount;
+		}
+		int m_callCount = 0;
+	};
+
+	//a root with independent subtrees, each one a chain of containers that own LocalIntPD at the top
+	struct Forest
+	{
+		ps::PropertyContainer m_root;
+		std::vector<ps::PropertyContainer*> m_heads;
+		std::vector<CountingContainer*> m_leafs;
+		std::vector<std::vector<std::string>> m_emitOrder;
+
+		explicit Forest(size_t subtreeCount)
+			: m_emitOrder(subtreeCount)
+		{
+			m_root.setProperty(IntPD, 0);
+			for (size_t i = 0; i < subtreeCount; ++i)
+			{
+				auto& head = m_root.addChildContainer<ps::PropertyContainer>();
+				head.setIndependentSubtree();
+				head.setProperty(LocalIntPD, 0);
+				head.setProperty(OtherLocalIntPD, 0);
+				auto& middle = head.addChildContainer<ps::PropertyContainer>();
+				middle.setProperty(IntPD, 0);
+				auto& leaf = middle.addChildContainer<CountingContainer>();
+				auto& order = m_emitOrder[i];
+				leaf.connect(LocalIntPD, [&order]() { order.push_back("head"); });
+				leaf.connect(IntPD, [&order]() { order.push_back("middle"); });
+				leaf.connect(LocalIntPD, &CountingContainer::onChanged);
+				leaf.connect(OtherLocalIntPD, &CountingContainer::onChanged);
+				leaf.connect(IntPD, &CountingContainer::onChanged);
+				m_heads.push_back(&head);
+				m_leafs.push_back(&leaf);
+			}
+			m_root.emit();
+			for (auto& order : m_emitOrder)
+				order.clear();
+			for (auto* leaf : m_leafs)
+				leaf->m_callCount = 0;
+		}
+
+		void change(int value)
+		{
+			for (auto* head : m_heads)
+			{
+				//the middle container is changed first, but the head has to be emitted first
+				(*head)[0]->changeProperty(IntPD, value);
+				head->changeProperty(LocalIntPD, value);
+				head->changeProperty(OtherLocalIntPD, value);
+			}
+		}
+	};
+}
+
+//###########################################################################
+//#
+//#                    ThreadPool Tests
+//#
+//###########################################################################
+
+TEST(ThreadPoolTest, parallelFor_manyTasks_allInvokedOnce)
+{
+	ps::ThreadPool threadPool(4);
+	std::vector<std::atomic<int>> invoked(1000);
+	threadPool.parallelFor(invoked.size(), [&invoked](size_t i) { invoked[i].fetch_add(1); });
+
+	for (auto& count : invoked)
+		ASSERT_EQ(count.load(), 1);
+}
+
+TEST(ThreadPoolTest, parallelFor_nested_noDeadlock)
+{
+	ps::ThreadPool threadPool(2);
+	std::atomic<int> invoked{ 0 };
+	threadPool.parallelFor(8, [&](size_t) {
+		threadPool.parallelFor(8, [&](size_t) { invoked.fetch_add(1); });
+	});
+
+	ASSERT_EQ(invoked.load(), 64);
+}
+
+TEST(ThreadPoolTest, parallelFor_throwingTask_rethrownAfterAllTasks)
+{
+	ps::ThreadPool threadPool(4);
+	std::atomic<int> invoked{ 0 };
+	ASSERT_THROW(threadPool.parallelFor(100, [&invoked](size_t i) {
+		invoked.fetch_add(1);
+		if (i % 10 == 3)
+			throw std::runtime_error("task failed");
+	}), std::runtime_error);
+
+	ASSERT_EQ(invoked.load(), 100);
+}
+
+//###########################################################################
+//#
+//#                    Parallel Emit Tests
+//#
+//###########################################################################
+
+TEST(ParallelEmitTest, emit_independentSubtrees_orderWithinSubtreeKept)
+{
+	ps::ThreadPool threadPool(4);
+	Forest forest(8);
+
+	forest.change(1);
+	forest.m_root.emit(threadPool);
+
+	for (auto& order : forest.m_emitOrder)
+		ASSERT_EQ(order, (std::vector<std::string>{ "head", "middle" }));
+}
+
+TEST(ParallelEmitTest, emit_independentSubtrees_duplicatesEliminatedPerSubtree)
+{
+	ps::ThreadPool threadPool(4);
+	Forest forest(8);
+
+	//the head and the middle container emit separately, the two changes of the head only invoke the PMF once
+	forest.change(1);
+	forest.m_root.emit(threadPool);
+	for (auto* leaf : forest.m_leafs)
+		ASSERT_EQ(leaf->m_callCount, 2);
+
+	forest.change(2);
+	forest.m_root.emit(threadPool, false);
+	for (auto* leaf : forest.m_leafs)
+		ASSERT_EQ(leaf->m_callCount, 5);
+}
+
+TEST(ParallelEmitTest, emit_throwingSlot_rethrownAndNextEmitWorks)
+{
+	ps::ThreadPool threadPool(4);
+	Forest forest(8);
+	forest.m_leafs[3]->connect(LocalIntPD, [](int value) {
+		if (value == 1)
+			throw std::runtime_error("slot failed");
+	});
+
+	forest.change(1);
+	ASSERT_THROW(forest.m_root.emit(threadPool), std::runtime_error);
+	for (size_t i = 0; i < forest.m_leafs.size(); ++i)
+	{
+		if (i != 3)
+			ASSERT_EQ(forest.m_leafs[i]->m_callCount, 2);
+	}
+
+	forest.change(2);
+	forest.m_root.emit(threadPool);
+	for (auto& order : forest.m_emitOrder)
+		ASSERT_EQ(order.back(), "middle");
+	for (size_t i = 0; i < forest.m_leafs.size(); ++i)
+	{
+		if (i != 3)
+			ASSERT_EQ(forest.m_leafs[i]->m_callCount, 4);
+	}
+}
+
+TEST(ParallelEmitTest, emit_propertyOwnedAboveIndependentSubtree_observersNotified)
+{
+	ps::ThreadPool threadPool(2);
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 0);
+	auto& head = root.addChildContainer<ps::PropertyContainer>();
+	head.setIndependentSubtree();
+	auto& child = head.addChildContainer<ps::PropertyContainer>();
+	int observedValue = 0;
+	child.connectToVar(IntPD, observedValue);
+
+	root.changeProperty(IntPD, 5);
+	root.emit(threadPool);
+
+	ASSERT_EQ(observedValue, 5);
+}
+
+TEST(ParallelEmitTest, setIndependentSubtree_pendingChanges_stillEmitted)
+{
+	ps::PropertyContainer root;
+	auto& head = root.addChildContainer<ps::PropertyContainer>();
+	auto& child = head.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(LocalIntPD, 0);
+	int observedValue = 0;
+	child.connectToVar(LocalIntPD, observedValue);
+	root.emit();
+
+	child.changeProperty(LocalIntPD, 3);
+	head.setIndependentSubtree();
+	root.emit();
+	ASSERT_EQ(observedValue, 3);
+
+	child.changeProperty(LocalIntPD, 4);
+	head.setIndependentSubtree(false);
+	root.emit();
+	ASSERT_EQ(observedValue, 4);
+}
+
+//###########################################################################
+//#
+//#                    postChange Tests
+//#
+//###########################################################################
+
+TEST(PostChangeTest, postChange_beforeEmit_appliedAtEmit)
+{
+	ps::PropertyContainer root;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(IntPD, 0);
+	int observedValue = 0;
+	child.connectToVar(IntPD, observedValue);
+
+	child.postChange(IntPD, 1);
+	ASSERT_EQ(child.getProperty(IntPD), 0);
+
+	root.emit();
+	ASSERT_EQ(child.getProperty(IntPD), 1);
+	ASSERT_EQ(observedValue, 1);
+}
+
+TEST(PostChangeTest, postChange_samePropertyPostedTwice_lastValueWins)
+{
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 0);
+	root.setProperty(LocalIntPD, 0);
+	int callCount = 0;
+	root.connect(IntPD, [&callCount]() { ++callCount; });
+
+	root.postChange(IntPD, 1);
+	root.postChange(LocalIntPD, 7);
+	root.postChange(IntPD, 2);
+	root.emit();
+
+	ASSERT_EQ(root.getProperty(IntPD), 2);
+	ASSERT_EQ(root.getProperty(LocalIntPD), 7);
+	ASSERT_EQ(callCount, 1);
+}
+
+TEST(PostChangeTest, removeChild_pendingChanges_stayPendingUntilEmit)
+{
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 0);
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(LocalIntPD, 0);
+
+	root.postChange(IntPD, 1);
+	child.postChange(LocalIntPD, 2);
+	auto detachedChild = root.removeChild(child);
+	//detaching doesn't apply the changes, the change of the child moves with it
+	ASSERT_EQ(root.getProperty(IntPD), 0);
+	ASSERT_EQ(detachedChild->getProperty(LocalIntPD), 0);
+
+	root.emit();
+	ASSERT_EQ(root.getProperty(IntPD), 1);
+	ASSERT_EQ(detachedChild->getProperty(LocalIntPD), 0);
+	detachedChild->emit();
+	ASSERT_EQ(detachedChild->getProperty(LocalIntPD), 2);
+}
+
+TEST(PostChangeTest, addChildContainer_pendingChangesOfChild_appliedByEmitOfNewRoot)
+{
+	ps::PropertyContainer root;
+	auto child = std::make_unique<ps::PropertyContainer>();
+	child->setProperty(LocalIntPD, 0);
+	child->postChange(LocalIntPD, 3);
+
+	auto& addedChild = root.addChildContainer(std::move(child));
+	ASSERT_EQ(addedChild.getProperty(LocalIntPD), 0);
+	root.emit();
+	ASSERT_EQ(addedChild.getProperty(LocalIntPD), 3);
+}
+
+TEST(PostChangeTest, postChange_fromManyThreads_allContainersUpdated)
+{
+	constexpr int threadCount = 8;
+	constexpr int postsPerThread = 1000;
+	ps::PropertyContainer root;
+	std::vector<ps::PropertyContainer*> containers;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		containers.push_back(&root.addChildContainer<ps::PropertyContainer>());
+		containers.back()->setProperty(IntPD, 0);
+	}
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([container = containers[i]]() {
+			for (int value = 1; value <= postsPerThread; ++value)
+				container->postChange(IntPD, value);
+		});
+	}
+	//emitting concurrently to the producers is allowed
+	for (int i = 0; i < 10; ++i)
+		root.emit();
+	for (auto& thread : threads)
+		thread.join();
+	root.emit();
+
+	for (auto* container : containers)
+		ASSERT_EQ(container->getProperty(IntPD), postsPerThread);
+}
+
+//###########################################################################
+//#
+//#                    ConcurrentReads Tests
+//#
+//###########################################################################
+
+namespace
+{
+	//the invariant m_a + m_b == 0 is broken by a torn read
+	struct Balance
+	{
+		int64_t m_a = 0;
+		int64_t m_b = 0;
+		int64_t m_padding[4] = {};
+		bool operator==(const Balance& other) const
+		{
+			return m_a == other.m_a && m_b == other.m_b;
+		}
+	};
+	ps::PropertyDescriptor<Balance> BalancePD(Balance{});
+	ps::PropertyDescriptor<std::vector<int>> ValuesPD(std::vector<int>{});
+
+	struct Tracked
+	{
+		static inline std::atomic<int> s_liveCount = 0;
+		int m_value = 0;
+		Tracked(int value = 0) : m_value(value) { ++s_liveCount; }
+		Tracked(const Tracked& other) : m_value(other.m_value) { ++s_liveCount; }
+		~Tracked() { --s_liveCount; }
+	};
+}
+
+TEST(ConcurrentReadsTest, add_initialValue_readable)
+{
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 3);
+	ps::ConcurrentReads<> reads(root);
+	auto view = reads.add(IntPD);
+	ASSERT_EQ(view.get(), 3);
+	root.setProperty(IntPD, 5);
+	//the readers see the values of the last emit
+	ASSERT_EQ(view.get(), 3);
+	root.emit();
+	ASSERT_EQ(view.get(), 5);
+}
+
+TEST(ConcurrentReadsTest, removeProperty_defaultValueRead)
+{
+	ps::PropertyContainer root;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(IntPD, 3);
+	ps::ConcurrentReads<> reads(child);
+	auto view = reads.add(IntPD);
+	child.removeProperty(IntPD);
+	root.emit();
+	ASSERT_EQ(view.get(), 0);
+}
+
+TEST(ConcurrentReadsTest, proxyProperty_destroyed_viewKeepsLastValue)
+{
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 2);
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(LocalIntPD, ps::make_proxy_property([](int value) { return value * 10; }, IntPD));
+	root.emit();
+	ps::ConcurrentPropertyView<int> view;
+	{
+		ps::ConcurrentReads<> reads(child);
+		view = reads.add(LocalIntPD);
+		ASSERT_EQ(view.get(), 20);
+		root.setProperty(IntPD, 4);
+		root.emit();
+		ASSERT_EQ(view.get(), 40);
+	}
+	child.removeProperty(LocalIntPD);
+	root.removeChild(child);
+	ASSERT_EQ(view.get(), 40);
+}
+
+TEST(ConcurrentReadsTest, seqlock_concurrentWriter_noTornReads)
+{
+	ps::PropertyContainer root;
+	root.setProperty(BalancePD, Balance{});
+	ps::ConcurrentReads<> reads(root);
+	auto view = reads.add(BalancePD);
+	std::atomic<bool> isDone = false;
+	std::thread reader([&]() {
+		int64_t lastValue = 0;
+		while (!isDone.load())
+		{
+			const Balance balance = view.get();
+			ASSERT_EQ(balance.m_a + balance.m_b, 0);
+			ASSERT_EQ(balance.m_padding[3], balance.m_a);
+			ASSERT_GE(balance.m_a, lastValue);
+			lastValue = balance.m_a;
+		}
+	});
+	for (int64_t i = 1; i <= 20000; ++i)
+	{
+		root.setProperty(BalancePD, Balance{ i, -i, { i, i, i, i } });
+		root.emit();
+	}
+	isDone = true;
+	reader.join();
+	ASSERT_EQ(view.get().m_a, 20000);
+}
+
+TEST(ConcurrentReadsTest, epoch_concurrentWriter_consistentValues)
+{
+	ps::PropertyContainer root;
+	root.setProperty(ValuesPD, std::vector<int>(64, 0));
+	ps::ConcurrentReads<> reads(root);
+	auto view = reads.add(ValuesPD);
+	std::atomic<bool> isDone = false;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&]() {
+			while (!isDone.load())
+			{
+				view.visit([](const std::vector<int>& values) {
+					ASSERT_EQ(values.size(), 64u);
+					for (int value : values)
+						ASSERT_EQ(value, values.front());
+				});
+			}
+		});
+	}
+	for (int i = 1; i <= 5000; ++i)
+	{
+		root.setProperty(ValuesPD, std::vector<int>(64, i));
+		root.emit();
+	}
+	isDone = true;
+	for (auto& reader : readers)
+		reader.join();
+	ASSERT_EQ(view.get().front(), 5000);
+}
+
+TEST(ConcurrentReadsTest, epoch_retiredWhilePinned_deletedAfterUnpin)
+{
+	const int liveCount = Tracked::s_liveCount;
+	auto& domain = ps::EpochDomain::global();
+	{
+		ps::ConcurrentValue<Tracked> value(Tracked(1));
+		ASSERT_GT(Tracked::s_liveCount, liveCount);
+		std::atomic<bool> isPinned = false;
+		std::atomic<bool> isStored = false;
+		std::thread reader([&]() {
+			value.visit([&](const Tracked& tracked) {
+				isPinned = true;
+				while (!isStored.load())
+					std::this_thread::yield();
+				//the old value is still alive, although it was replaced
+				ASSERT_EQ(tracked.m_value, 1);
+			});
+		});
+		while (!isPinned.load())
+			std::this_thread::yield();
+		value.store(Tracked(2));
+		ASSERT_EQ(Tracked::s_liveCount, liveCount + 2);
+		isStored = true;
+		reader.join();
+		domain.reclaim();
+		ASSERT_EQ(Tracked::s_liveCount, liveCount + 1);
+		ASSERT_EQ(value.load().m_value, 2);
+	}
+	ASSERT_EQ(Tracked::s_liveCount, liveCount);
+}
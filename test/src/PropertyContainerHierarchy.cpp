@@ -227,3 +227,294 @@ TEST(CppPropertiesTest, TestSignals_disconnectAll_NoUpdateCall)
 	ASSERT_EQ(localInt, 42);
 }
 
+
+TEST(CppPropertiesTest, TestSignals_connectPMFInChild_invokedOnChildInstance)
+{
+	ps::PropertyContainer rootContainer;
+	auto& childContainer = rootContainer.addChildContainer<IntPP>();
+	childContainer.connect(IntPD, &IntPP::dirtyIntFunc);
+
+	rootContainer.setProperty(IntPD, 5);
+	rootContainer.emit();
+
+	ASSERT_EQ(childContainer.dirtyInt, 5);
+}
+
+TEST(CppPropertiesTest, TestSignals_setAtIntermediateLevel_signalsRoutedToNewOwner)
+{
+	ps::PropertyContainer rootContainer;
+	auto& containerA = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& containerA1 = containerA.addChildContainer<ps::PropertyContainer>();
+	auto& containerB = rootContainer.addChildContainer<ps::PropertyContainer>();
+	int valueA1 = 0;
+	int valueB = 0;
+	containerA1.connectToVar(IntPD, valueA1);
+	containerB.connectToVar(IntPD, valueB);
+
+	rootContainer.setProperty(IntPD, 1);
+	containerA.setProperty(IntPD, 2);
+	rootContainer.emit();
+	ASSERT_EQ(valueA1, 2);
+	ASSERT_EQ(valueB, 1);
+
+	rootContainer.changeProperty(IntPD, 3);
+	rootContainer.emit();
+	ASSERT_EQ(valueA1, 2);
+	ASSERT_EQ(valueB, 3);
+
+	containerA.removeProperty(IntPD);
+	rootContainer.emit();
+	ASSERT_EQ(valueA1, 3);
+}
+
+TEST(CppPropertiesTest, TestSignals_addConnectedSubtree_signalsRoutedToOwner)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 1);
+	auto subtree = std::make_unique<ps::PropertyContainer>();
+	auto& subtreeChild = subtree->addChildContainer<ps::PropertyContainer>();
+	int observedValue = 0;
+	subtreeChild.connectToVar(IntPD, observedValue);
+
+	rootContainer.addChildContainer(std::move(subtree));
+	rootContainer.changeProperty(IntPD, 7);
+	rootContainer.emit();
+
+	ASSERT_EQ(subtreeChild.getProperty(IntPD), 7);
+	ASSERT_EQ(observedValue, 7);
+}
+
+TEST(CppPropertiesTest, TestEmit_changesAtDifferentDepths_parentsEmittedFirst)
+{
+	ps::PropertyContainer rootContainer;
+	auto& containerA = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& containerA1 = containerA.addChildContainer<ps::PropertyContainer>();
+	rootContainer.setProperty(IntPD, 0);
+	containerA1.setProperty(StringPD, "A1");
+	std::vector<std::string> emitOrder;
+	containerA1.connect(StringPD, [&emitOrder]() { emitOrder.push_back("A1"); });
+	containerA1.connect(IntPD, [&emitOrder]() { emitOrder.push_back("root"); });
+	rootContainer.emit();
+	emitOrder.clear();
+
+	containerA1.changeProperty(StringPD, "changed");
+	rootContainer.changeProperty(IntPD, 1);
+	rootContainer.emit();
+
+	ASSERT_EQ(emitOrder, (std::vector<std::string>{ "root", "A1" }));
+}
+
+TEST(CppPropertiesTest, TestEmit_emitAtChild_onlySubtreeEmitted)
+{
+	ps::PropertyContainer rootContainer;
+	auto& containerA = rootContainer.addChildContainer<ps::PropertyContainer>();
+	rootContainer.setProperty(IntPD, 0);
+	containerA.setProperty(StringPD, "A");
+	int rootValue = 0;
+	std::string valueA;
+	rootContainer.connectToVar(IntPD, rootValue);
+	containerA.connectToVar(StringPD, valueA);
+
+	rootContainer.changeProperty(IntPD, 5);
+	containerA.changeProperty(StringPD, "changed");
+	containerA.emit();
+	ASSERT_EQ(rootValue, 0);
+	ASSERT_EQ(valueA, "changed");
+
+	rootContainer.emit();
+	ASSERT_EQ(rootValue, 5);
+}
+
+TEST(CppPropertiesTest, TestEmit_dirtyProxyReplaced_noStaleContainerEmitted)
+{
+	ps::PropertyContainer rootContainer;
+	int observedValue = 0;
+	rootContainer.connectToVar(IntPD, observedValue);
+	rootContainer.setProperty(IntPD, std::make_unique<IntPP>());
+	rootContainer.emit();
+	ASSERT_EQ(observedValue, 42);
+	//the old proxy is registered as dirty when it gets replaced and destroyed
+	auto* proxy = const_cast<ps::ProxyProperty<int>*>(rootContainer.getProxyProperty(IntPD));
+	proxy->setProperty(StringPD, "dirty");
+	observedValue = 0;
+
+	rootContainer.setProperty(IntPD, std::make_unique<IntPP>());
+	rootContainer.emit();
+
+	ASSERT_EQ(observedValue, 42);
+}
+
+TEST(CppPropertiesTest, TestBatch_setWithinBatch_signalsReroutedAtEnd)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 1);
+	rootContainer.setProperty(StringPD, "root");
+	auto& containerA = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& containerB = containerA.addChildContainer<ps::PropertyContainer>();
+	int valueB = 0;
+	std::string stringB;
+	containerB.connectToVar(IntPD, valueB);
+	containerB.connectToVar(StringPD, stringB);
+	rootContainer.emit();
+
+	{
+		auto batch = containerA.batch();
+		auto nestedBatch = containerA.batch();
+		containerA.setProperty(IntPD, 2);
+		containerA.setProperty(StringPD, "A");
+		containerA.setProperty(IntPD, 3);
+	}
+	rootContainer.emit();
+	ASSERT_EQ(valueB, 3);
+	ASSERT_EQ(stringB, "A");
+
+	//the signals of B are routed to A now, changes at the root aren't visible to B anymore
+	rootContainer.changeProperty(IntPD, 10);
+	rootContainer.emit();
+	ASSERT_EQ(valueB, 3);
+	containerA.changeProperty(IntPD, 4);
+	rootContainer.emit();
+	ASSERT_EQ(valueB, 4);
+}
+
+TEST(CppPropertiesTest, TestReparent_moveChild_observesNewParent)
+{
+	ps::PropertyContainer rootContainer;
+	auto& containerA = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& containerB = rootContainer.addChildContainer<ps::PropertyContainer>();
+	containerA.setProperty(IntPD, 1);
+	containerB.setProperty(IntPD, 2);
+	auto& child = containerA.addChildContainer<ps::PropertyContainer>();
+	auto& grandChild = child.addChildContainer<ps::PropertyContainer>();
+	int observedValue = 0;
+	grandChild.connectToVar(IntPD, observedValue);
+	rootContainer.emit();
+	ASSERT_EQ(observedValue, 1);
+
+	containerA.reparent(child, containerB);
+	ASSERT_EQ(containerA.size(), 0u);
+	ASSERT_EQ(containerB.size(), 1u);
+	ASSERT_EQ(grandChild.getProperty(IntPD), 2);
+
+	containerA.changeProperty(IntPD, 10);
+	rootContainer.emit();
+	ASSERT_EQ(observedValue, 1);
+	containerB.changeProperty(IntPD, 20);
+	rootContainer.emit();
+	ASSERT_EQ(observedValue, 20);
+}
+
+TEST(CppPropertiesTest, TestRemoveChild_removeMiddleChild_remainingChildrenKept)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 1);
+	auto& first = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& middle = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& last = rootContainer.addChildContainer<ps::PropertyContainer>();
+	middle.setProperty(StringPD, "middle");
+
+	auto removed = rootContainer.removeChild(middle);
+	ASSERT_EQ(removed.get(), &middle);
+	ASSERT_EQ(rootContainer.size(), 2u);
+	ASSERT_EQ(rootContainer[0].get(), &first);
+	ASSERT_EQ(rootContainer[1].get(), &last);
+	//the removed child is a root now, it keeps its own properties but doesn't see the ones of the previous parent
+	ASSERT_EQ(middle.getProperty(StringPD), "middle");
+	ASSERT_FALSE(middle.hasProperty(IntPD));
+
+	rootContainer.removeChild(first);
+	rootContainer.removeChild(last);
+	ASSERT_EQ(rootContainer.size(), 0u);
+}
+
+TEST(CppPropertiesTest, TestAddChildren_range_allChildrenAdded)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 3);
+	std::vector<std::unique_ptr<ps::PropertyContainer>> children;
+	std::vector<int> observedValues(4, 0);
+	for (auto& observedValue : observedValues)
+	{
+		children.push_back(std::make_unique<ps::PropertyContainer>());
+		children.back()->connectToVar(IntPD, observedValue);
+	}
+
+	rootContainer.addChildren(std::move(children));
+	rootContainer.changeProperty(IntPD, 4);
+	rootContainer.emit();
+
+	ASSERT_EQ(rootContainer.size(), 4u);
+	for (int observedValue : observedValues)
+		ASSERT_EQ(observedValue, 4);
+}
+
+TEST(CppPropertiesTest, TestAddChildren_lvalueRangeOfSharedPtrs_rangeKeepsChildren)
+{
+	ps::PropertyContainer rootContainer;
+	std::vector<std::shared_ptr<ps::PropertyContainer>> children{ std::make_shared<ps::PropertyContainer>(), std::make_shared<ps::PropertyContainer>() };
+
+	rootContainer.addChildren(children);
+
+	ASSERT_EQ(rootContainer.size(), 2u);
+	ASSERT_EQ(rootContainer[0], children[0]);
+	ASSERT_EQ(rootContainer[1], children[1]);
+}
+
+TEST(CppPropertiesTest, TestHandle_ownerChanges_handleFollowsOwner)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 1);
+	auto& child = rootContainer.addChildContainer<ps::PropertyContainer>();
+	auto& grandChild = child.addChildContainer<ps::PropertyContainer>();
+	auto handle = grandChild.handle(IntPD);
+	ASSERT_EQ(handle.get(), 1);
+
+	//changing a value doesn't invalidate the handle
+	const auto generation = rootContainer.getGeneration();
+	rootContainer.changeProperty(IntPD, 2);
+	ASSERT_EQ(rootContainer.getGeneration(), generation);
+	ASSERT_EQ(handle.get(), 2);
+
+	child.setProperty(IntPD, 3);
+	ASSERT_EQ(handle.get(), 3);
+	child.removeProperty(IntPD);
+	ASSERT_EQ(handle.get(), 2);
+
+	ps::PropertyContainer otherRoot;
+	otherRoot.setProperty(IntPD, 4);
+	rootContainer.reparent(child, otherRoot);
+	ASSERT_EQ(handle.get(), 4);
+	otherRoot.removeProperty(IntPD);
+	ASSERT_EQ(handle.get(), IntPD.getDefaultValue().get());
+}
+
+TEST(CppPropertiesTest, TestHandle_otherHierarchyChanges_generationKept)
+{
+	ps::PropertyContainer rootContainer;
+	rootContainer.setProperty(IntPD, 1);
+	auto handle = rootContainer.handle(IntPD);
+	const auto generation = rootContainer.getGeneration();
+
+	ps::PropertyContainer prototype;
+	auto instance = prototype.clone();
+	instance->setProperty(IntPD, 2);
+	prototype.addChildContainer<ps::PropertyContainer>();
+
+	ASSERT_EQ(rootContainer.getGeneration(), generation);
+	ASSERT_EQ(handle.get(), 1);
+}
+
+TEST(CppPropertiesTest, TestHandle_previousRootDestroyed_handleFollowsNewRoot)
+{
+	ps::PropertyContainer newRoot;
+	newRoot.setProperty(IntPD, 5);
+	auto previousRoot = std::make_unique<ps::PropertyContainer>();
+	previousRoot->setProperty(IntPD, 4);
+	auto& child = previousRoot->addChildContainer<ps::PropertyContainer>();
+	auto handle = child.handle(IntPD);
+	ASSERT_EQ(handle.get(), 4);
+
+	previousRoot->reparent(child, newRoot);
+	previousRoot.reset();
+	ASSERT_EQ(handle.get(), 5);
+}
@@ -58,6 +58,48 @@ TEST(PropertyContainerTest, copyConstructor_propertyExists_newValue)
 	ASSERT_EQ(copy.getProperty(IntPD), 2);
 }
 
+TEST(PropertyContainerTest, clone_changeEitherContainer_otherKeepsValue)
+{
+	ps::PropertyContainer prototype;
+	prototype.setProperty(StringPD, "prototype");
+	prototype.setProperty(IntPD, 1);
+
+	auto clone = prototype.clone();
+	auto other = prototype.clone();
+	//the clones share the property of the prototype until they change it
+	ASSERT_EQ(&clone->getProperty(StringPD), &prototype.getProperty(StringPD));
+	ASSERT_EQ(clone->getProperty(IntPD), 1);
+
+	clone->changeProperty(StringPD, "clone");
+	prototype.changeProperty(StringPD, "changed prototype");
+	ASSERT_EQ(clone->getProperty(StringPD).get(), "clone");
+	ASSERT_EQ(other->getProperty(StringPD).get(), "prototype");
+	ASSERT_EQ(prototype.getProperty(StringPD).get(), "changed prototype");
+}
+
+TEST(PropertyContainerTest, clone_changeSharedProperty_onlyCloneSignaled)
+{
+	ps::PropertyContainer root;
+	auto& prototype = root.addChildContainer<ps::PropertyContainer>();
+	prototype.setProperty(StringPD, "prototype");
+	auto& clone = root.addChildContainer(prototype.clone());
+	int prototypeCalled = 0;
+	int cloneCalled = 0;
+	prototype.connect(StringPD, [&prototypeCalled](const std::string&) { ++prototypeCalled; });
+	clone.connect(StringPD, [&cloneCalled](const std::string&) { ++cloneCalled; });
+	root.emit();
+	prototypeCalled = cloneCalled = 0;
+
+	clone.changeProperty(StringPD, "clone");
+	root.emit();
+	ASSERT_EQ(prototypeCalled, 0);
+	ASSERT_EQ(cloneCalled, 1);
+	prototype.changeProperty(StringPD, "changed prototype");
+	root.emit();
+	ASSERT_EQ(prototypeCalled, 1);
+	ASSERT_EQ(cloneCalled, 1);
+}
+
 TEST(PropertyContainerTest, setAndGetProperty_testNonCopyable_valueGetAndSet)
 {
 	ps::PropertyContainer root;
@@ -125,4 +167,67 @@ TEST(PropertyContainerTest, setMultipleProperties_getProperty_newValue)
 		ASSERT_TRUE(root.getProperty(pd) == pd.getDefaultValue().get() + newString);
 	for (auto& pd : propertyListInt)
 		ASSERT_TRUE(root.getProperty(pd) == pd.getDefaultValue().get() * 2);
-}
\ No newline at end of file
+}
+//###########################################################################
+//#
+//#                    PropertyContainer Tests     
+//#                      storage backends
+//#
+//###########################################################################
+
+TEST(PropertyContainerTest, descriptorIds_sequentialIds_areDense)
+{
+	ps::PropertyDescriptor<int> firstPD(0);
+	ps::PropertyDescriptor<int> secondPD(0);
+
+	ASSERT_EQ(secondPD.getId(), firstPD.getId() + 1);
+}
+
+TEST(PropertyContainerTest, hashMapBackend_setAndGetProperty_newValue)
+{
+	using HashedContainer = ps::PropertyContainerBase<std::unordered_map>;
+	HashedContainer root;
+	auto& child = root.addChildContainer<HashedContainer>();
+	int observedValue = 0;
+	child.connect(IntPD, [&observedValue](int value) { observedValue = value; });
+
+	root.setProperty(IntPD, 42);
+	root.emit();
+
+	ASSERT_EQ(child.getProperty(IntPD), 42);
+	ASSERT_EQ(observedValue, 42);
+}
+
+TEST(PropertyContainerTest, denseMap_eraseAndReinsert_referencesStayValid)
+{
+	ps::DenseMap<const ps::PropertyDescriptorBase*, int> map;
+	map[&IntPD] = 1;
+	int& stringValue = map[&StringPD];
+	stringValue = 2;
+
+	map.erase(&IntPD);
+	map[&IntPD] = 3;
+
+	ASSERT_EQ(&map.at(&StringPD), &stringValue);
+	ASSERT_EQ(map.size(), 2u);
+	ASSERT_EQ(map.at(&IntPD), 3);
+}
+
+TEST(PropertyContainerTest, denseMap_keysOfDistantIds_areFoundAndIterated)
+{
+	//the PDs are spread over several pages of the id index
+	std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> pds;
+	for (int i = 0; i < 300; ++i)
+		pds.push_back(std::make_unique<ps::PropertyDescriptor<int>>(int(i)));
+	ps::DenseMap<const ps::PropertyDescriptorBase*, int> map;
+	map[pds.back().get()] = 2;
+	map[&IntPD] = 1;
+
+	ASSERT_EQ(map.size(), 2u);
+	ASSERT_EQ(map.count(pds[150].get()), 0u);
+	ASSERT_EQ(map.at(pds.back().get()), 2);
+	ASSERT_EQ(map.begin()->first, pds.back().get());
+	ASSERT_EQ(map.erase(pds.back().get()), 1u);
+	ASSERT_EQ(map.find(pds.back().get()), map.end());
+	ASSERT_EQ(map.at(&IntPD), 1);
+}
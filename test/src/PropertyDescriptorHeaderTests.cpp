@@ -0,0 +1,14 @@
+//this translation unit only includes the descriptor header, it must compile without the container
+#include <cppproperties/PropertyDescriptor.h>
+#include <gtest/gtest.h>
+
+namespace
+{
+	const ps::PropertyDescriptor<int> StandalonePD{ 3, "StandaloneHeaderPD" };
+}
+
+TEST(PropertyDescriptorHeader, descriptorHeaderIsSelfContained)
+{
+	EXPECT_EQ(StandalonePD.getDefaultValue(), 3);
+	EXPECT_EQ(ps::PropertyDescriptorRegistry::global().find("StandaloneHeaderPD"), &StandalonePD);
+}
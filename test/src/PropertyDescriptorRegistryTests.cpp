@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <cppproperties/PropertyContainer.h>
+
+#include <limits>
+#include <string>
+
+//###########################################################################
+//#
+//#                    PropertyDescriptorRegistry Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	ps::PropertyDescriptor<int> CountPD(0, "registry.count");
+	ps::PropertyDescriptor<float> RatioPD(1.f, "registry.ratio");
+	ps::PropertyDescriptor<bool> EnabledPD(false, "registry.enabled");
+	ps::PropertyDescriptor<std::string> TitlePD("", "registry.title");
+	ps::PropertyDescriptor<std::vector<int>> IdsPD(std::vector<int>{}, "registry.ids");
+}
+
+TEST(PropertyDescriptorRegistry, find_namedPD_isRegisteredGlobally)
+{
+	auto& registry = ps::PropertyDescriptorRegistry::global();
+	EXPECT_EQ(registry.find("registry.count"), &CountPD);
+	EXPECT_EQ(registry.find("registry.title"), &TitlePD);
+	EXPECT_EQ(registry.find("registry.unknown"), nullptr);
+	{
+		ps::PropertyDescriptor<int> ScopedPD(0, "registry.scoped");
+		EXPECT_EQ(registry.find("registry.scoped"), &ScopedPD);
+	}
+	EXPECT_EQ(registry.find("registry.scoped"), nullptr);
+}
+
+TEST(PropertyDescriptorRegistry, find_duplicateName_nextPDIsFoundAfterRemoval)
+{
+	auto& registry = ps::PropertyDescriptorRegistry::global();
+	auto firstPD = std::make_unique<ps::PropertyDescriptor<int>>(1, "registry.duplicate");
+	auto secondPD = std::make_unique<ps::PropertyDescriptor<int>>(2, "registry.duplicate");
+	auto thirdPD = std::make_unique<ps::PropertyDescriptor<int>>(3, "registry.duplicate");
+	EXPECT_EQ(registry.find("registry.duplicate"), firstPD.get());
+
+	secondPD.reset();
+	EXPECT_EQ(registry.find("registry.duplicate"), firstPD.get());
+	firstPD.reset();
+	EXPECT_EQ(registry.find("registry.duplicate"), thirdPD.get());
+
+	{
+		ps::PropertyContainer container;
+		EXPECT_TRUE(container.setPropertyByName("registry.duplicate", "5"));
+		EXPECT_EQ(container.getProperty(*thirdPD), 5);
+	}
+	thirdPD.reset();
+	EXPECT_EQ(registry.find("registry.duplicate"), nullptr);
+}
+
+TEST(PropertyDescriptorRegistry, freeze_findsAllPDs)
+{
+	ps::PropertyDescriptorRegistry registry;
+	std::vector<std::unique_ptr<ps::PropertyDescriptor<int>>> pds;
+	for (int i = 0; i < 500; ++i)
+	{
+		pds.push_back(std::make_unique<ps::PropertyDescriptor<int>>(0, "registry.freeze" + std::to_string(i)));
+		registry.add(pds.back()->getName(), *pds.back());
+	}
+	ASSERT_TRUE(registry.freeze());
+	EXPECT_TRUE(registry.isFrozen());
+	for (auto& pd : pds)
+		EXPECT_EQ(registry.find(pd->getName()), pd.get());
+	EXPECT_EQ(registry.find("registry.freeze500"), nullptr);
+	EXPECT_EQ(registry.find(""), nullptr);
+
+	//PDs added or removed after the freeze are still handled
+	ps::PropertyDescriptor<int> LatePD(0, "registry.late");
+	registry.add(LatePD.getName(), LatePD);
+	EXPECT_EQ(registry.find("registry.late"), &LatePD);
+	registry.remove(pds[7]->getName(), *pds[7]);
+	EXPECT_EQ(registry.find(pds[7]->getName()), nullptr);
+	EXPECT_FALSE(registry.isFrozen());
+	EXPECT_EQ(registry.find(pds[8]->getName()), pds[8].get());
+	EXPECT_EQ(registry.size(), 500u);
+}
+
+TEST(PropertyDescriptorRegistry, setPropertyByName_convertsInput)
+{
+	ps::PropertyContainer container;
+	EXPECT_TRUE(container.setPropertyByName("registry.count", "42"));
+	EXPECT_EQ(container.getProperty(CountPD).get(), 42);
+	EXPECT_TRUE(container.setPropertyByName("registry.count", 7));
+	EXPECT_EQ(container.getProperty(CountPD).get(), 7);
+	EXPECT_TRUE(container.setPropertyByName("registry.ratio", 0.25));
+	EXPECT_EQ(container.getProperty(RatioPD).get(), 0.25f);
+	EXPECT_TRUE(container.setPropertyByName("registry.enabled", "true"));
+	EXPECT_TRUE(container.getProperty(EnabledPD).get());
+	EXPECT_TRUE(container.setPropertyByName("registry.title", "hello"));
+	EXPECT_EQ(container.getProperty(TitlePD).get(), "hello");
+}
+
+TEST(PropertyDescriptorRegistry, setPropertyByName_invalidInput_keepsValue)
+{
+	ps::PropertyContainer container;
+	container.setProperty(CountPD, 3);
+	EXPECT_FALSE(container.setPropertyByName("registry.count", "4x"));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", 4.5));
+	EXPECT_FALSE(container.setPropertyByName("registry.title", 1));
+	EXPECT_FALSE(container.setPropertyByName("registry.unknown", 1));
+	//there is no parser for vectors
+	EXPECT_FALSE(container.setPropertyByName("registry.ids", "1"));
+	EXPECT_EQ(container.getProperty(CountPD).get(), 3);
+	EXPECT_FALSE(container.hasProperty(TitlePD));
+}
+
+TEST(PropertyDescriptorRegistry, setPropertyByName_numberOutOfRange_rejected)
+{
+	ps::PropertyContainer container;
+	container.setProperty(CountPD, 3);
+	container.setProperty(RatioPD, 0.5f);
+	EXPECT_FALSE(container.setPropertyByName("registry.count", 1e20));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", -1e20));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", std::numeric_limits<double>::quiet_NaN()));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", std::numeric_limits<double>::infinity()));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", int64_t(std::numeric_limits<int>::max()) + 1));
+	EXPECT_FALSE(container.setPropertyByName("registry.count", int64_t(std::numeric_limits<int>::min()) - 1));
+	EXPECT_FALSE(container.setPropertyByName("registry.ratio", 1e300));
+	EXPECT_EQ(container.getProperty(CountPD).get(), 3);
+	EXPECT_EQ(container.getProperty(RatioPD).get(), 0.5f);
+
+	//the limits themselves are fine
+	EXPECT_TRUE(container.setPropertyByName("registry.count", int64_t(std::numeric_limits<int>::min())));
+	EXPECT_EQ(container.getProperty(CountPD).get(), std::numeric_limits<int>::min());
+	EXPECT_TRUE(container.setPropertyByName("registry.count", double(std::numeric_limits<int>::max())));
+	EXPECT_EQ(container.getProperty(CountPD).get(), std::numeric_limits<int>::max());
+}
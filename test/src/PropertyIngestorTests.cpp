@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <cppproperties/PropertyIngestor.h>
+#include <cppproperties/ProxyProperty.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//###########################################################################
+//#
+//#                    PropertyIngestor Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	ps::PropertyDescriptor<int> SpeedPD(0, "ingestor.speed");
+	ps::PropertyDescriptor<double> MassPD(1., "ingestor.mass");
+	ps::PropertyDescriptor<std::string> LabelPD("", "ingestor.label");
+	ps::PropertyDescriptor<int> DoubledSpeedPD(0, "ingestor.doubledSpeed");
+
+	void feedString(ps::PropertyIngestor& ingestor, const std::string& records)
+	{
+		ingestor.feed(records.data(), records.size());
+	}
+}
+
+TEST(PropertyIngestor, feed_recordsSetPropertiesAtPath)
+{
+	ps::PropertyContainer root;
+	auto& first = root.addChildContainer<ps::PropertyContainer>();
+	//proxy properties are children too, but they don't count for the path
+	first.setProperty(DoubledSpeedPD, ps::make_proxy_property([](int speed) { return speed * 2; }, SpeedPD));
+	auto& grandChild = first.addChildContainer<ps::PropertyContainer>();
+	auto& second = root.addChildContainer<ps::PropertyContainer>();
+
+	int signaledSpeed = 0;
+	grandChild.connect(SpeedPD, [&signaledSpeed](int speed) { signaledSpeed = speed; });
+
+	ps::PropertyIngestor ingestor(root);
+	feedString(ingestor, "# replay\n/ ingestor.speed 3\n/0/0 ingestor.label hello world\r\n/1 ingestor.mass 2.5\n\n/0 ingestor.speed 4");
+	ingestor.finish();
+
+	EXPECT_EQ(root.getProperty(SpeedPD), 3);
+	EXPECT_EQ(grandChild.getProperty(LabelPD), "hello world");
+	EXPECT_EQ(second.getProperty(MassPD), 2.5);
+	EXPECT_EQ(first.getProperty(DoubledSpeedPD), 8);
+	EXPECT_EQ(signaledSpeed, 4);
+	EXPECT_EQ(ingestor.getAppliedCount(), 4u);
+	EXPECT_EQ(ingestor.getRejectedCount(), 0u);
+}
+
+TEST(PropertyIngestor, feed_recordSplitOverChunks_appliedOnce)
+{
+	ps::PropertyContainer root;
+	int signalCount = 0;
+	root.connect(SpeedPD, [&signalCount](int) { ++signalCount; });
+
+	ps::PropertyIngestor ingestor(root, 2);
+	const std::string records = "/ ingestor.speed 1\n/ ingestor.speed 2\n/ ingestor.speed 3\n/ ingestor.speed 4\n/ ingestor.speed 42\n";
+	for (char c : records)
+		ingestor.feed(&c, 1);
+	//the last batch isn't full, so it's only emitted when the stream is finished
+	EXPECT_EQ(root.getProperty(SpeedPD), 42);
+	EXPECT_EQ(signalCount, 2);
+	ingestor.finish();
+	EXPECT_EQ(signalCount, 3);
+	EXPECT_EQ(ingestor.getAppliedCount(), 5u);
+}
+
+TEST(PropertyIngestor, feed_invalidRecords_rejected)
+{
+	ps::PropertyContainer root;
+	root.addChildContainer<ps::PropertyContainer>();
+	ps::PropertyIngestor ingestor(root);
+	feedString(ingestor, "/ ingestor.speed fast\n/5 ingestor.speed 1\n/x ingestor.speed 1\n/ ingestor.unknown 1\n/ingestor.speed\n/0 ingestor.speed 7\n");
+	ingestor.finish();
+	EXPECT_EQ(ingestor.getRejectedCount(), 5u);
+	EXPECT_EQ(ingestor.getAppliedCount(), 1u);
+	EXPECT_FALSE(root.hasProperty(SpeedPD));
+}
+
+TEST(PropertyIngestor, ingestFile_smallBuffer_appliesAllRecords)
+{
+	const std::string path = "ingestor_test.log";
+	{
+		std::ofstream file(path, std::ios::binary);
+		for (int i = 0; i <= 1000; ++i)
+			file << "/ ingestor.speed " << i << "\n";
+	}
+	ps::PropertyContainer root;
+	ps::PropertyIngestor ingestor(root, 64);
+	ingestor.ingestFile(path, 7);
+	std::remove(path.c_str());
+	EXPECT_EQ(root.getProperty(SpeedPD), 1000);
+	EXPECT_EQ(ingestor.getAppliedCount(), 1001u);
+	EXPECT_THROW(ingestor.ingestFile("does_not_exist.log"), std::runtime_error);
+}
+
+TEST(PropertyIngestor, feed_hierarchyRestructuredBetweenFeeds_pathsResolvedAgain)
+{
+	ps::PropertyContainer root;
+	auto& first = root.addChildContainer<ps::PropertyContainer>();
+	root.addChildContainer<ps::PropertyContainer>();
+	auto& third = root.addChildContainer<ps::PropertyContainer>();
+
+	ps::PropertyIngestor ingestor(root);
+	feedString(ingestor, "/0 ingestor.speed 1\n/2 ingestor.speed 3\n");
+	//the last child takes over the position of the removed one
+	auto removed = root.removeChild(first);
+	feedString(ingestor, "/0 ingestor.speed 5\n");
+	ingestor.finish();
+
+	EXPECT_EQ(removed->getProperty(SpeedPD), 1);
+	EXPECT_EQ(third.getProperty(SpeedPD), 5);
+	EXPECT_EQ(ingestor.getAppliedCount(), 3u);
+}
+
+TEST(PropertyIngestor, feed_slotRestructuresHierarchy_pathsResolvedAgain)
+{
+	ps::PropertyContainer root;
+	auto& first = root.addChildContainer<ps::PropertyContainer>();
+	auto& second = root.addChildContainer<ps::PropertyContainer>();
+	decltype(root.removeChild(root)) removed;
+	root.connect(LabelPD, [&](const std::string&) { removed = root.removeChild(first); });
+
+	//every record is emitted on its own
+	ps::PropertyIngestor ingestor(root, 1);
+	feedString(ingestor, "/0 ingestor.speed 1\n/ ingestor.label remove\n/0 ingestor.speed 2\n");
+	ingestor.finish();
+
+	ASSERT_TRUE(removed);
+	EXPECT_EQ(removed->getProperty(SpeedPD), 1);
+	EXPECT_EQ(second.getProperty(SpeedPD), 2);
+}
+
+TEST(PropertyIngestor, feed_moreTargetsThanCacheSize_allApplied)
+{
+	ps::PropertyContainer root;
+	std::vector<ps::PropertyContainer*> children;
+	for (int i = 0; i < 10; ++i)
+		children.push_back(&root.addChildContainer<ps::PropertyContainer>());
+	ps::PropertyIngestor ingestor(root, 3);
+	ingestor.setMaxCacheSize(2);
+	std::string records;
+	for (int round = 0; round < 3; ++round)
+	{
+		for (int i = 0; i < 10; ++i)
+			records += "/" + std::to_string(i) + " ingestor.speed " + std::to_string(round * 10 + i) + "\n";
+	}
+	feedString(ingestor, records);
+	ingestor.finish();
+
+	EXPECT_EQ(ingestor.getAppliedCount(), 30u);
+	for (size_t i = 0; i < 10; ++i)
+		EXPECT_EQ(children[i]->getProperty(SpeedPD), 20 + static_cast<int>(i));
+}
@@ -1,10 +1,16 @@
 #include <gtest/gtest.h>
 #include <cppproperties/PropertyContainer.h>
 #include <cppproperties/ProxyProperty.h>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
 namespace
 {
 	ps::PropertyDescriptor<int> IntPD(0);
 	ps::PropertyDescriptor<std::string> StringPD("Empty");
+	ps::PropertyDescriptor<float> OpacityPD(1.f, ps::EpsilonChangePolicy<float>(0.01f));
+	ps::PropertyDescriptor<std::vector<int>> BufferPD(std::vector<int>{}, ps::AlwaysChangedPolicy<std::vector<int>>());
 }
 
 ps::PropertyDescriptor<int*> IntPtrPD(nullptr);
@@ -61,5 +67,135 @@ TEST(PropertyTest, onPropertyChanged_disconnectByTypeIndex_oldValue)
 	ASSERT_EQ(newVal, 42);
 }
 
+TEST(PropertyTest, onPropertyChanged_disconnectDuringEmit_otherSlotsStillInvoked)
+{
+	ps::Property<int> intP(42);
+	int firstCalled = 0;
+	int secondCalled = 0;
+	size_t firstIdx = 0;
+	firstIdx = intP += [&](int) { ++firstCalled; intP -= firstIdx; };
+	intP += [&](int) { ++secondCalled; };
+
+	intP.set(1);
+	intP.set(2);
+
+	ASSERT_EQ(firstCalled, 1);
+	ASSERT_EQ(secondCalled, 2);
+}
+
+TEST(PropertyTest, onPropertyChanged_connectDuringEmit_invokedOnNextChange)
+{
+	ps::Property<int> intP(42);
+	int lateCalled = 0;
+	bool connected = false;
+	intP += [&](int) {
+		if (!connected)
+			intP += [&lateCalled](int) { ++lateCalled; };
+		connected = true;
+	};
+
+	intP.set(1);
+	ASSERT_EQ(lateCalled, 0);
+	intP.set(2);
+	ASSERT_EQ(lateCalled, 1);
+}
 
+TEST(PropertyTest, onPropertyChanged_lambdaWithLargeCapture_applyNewValue)
+{
+	ps::Property<int> intP(42);
+	std::array<int, 32> largeCapture{};
+	largeCapture[31] = 7;
+	int newVal = 0;
+	intP += [largeCapture, &newVal](int newValue) { newVal = newValue + largeCapture[31]; };
+
+	ps::Property<int> copy(intP);
+	intP.set(1);
+	ASSERT_EQ(newVal, 8);
+}
+
+//###########################################################################
+//#
+//#                    ChangePolicy Tests
+//#
+//###########################################################################
 
+TEST(ChangePolicyTest, epsilonPolicy_smallChange_notSignaled)
+{
+	ps::PropertyContainer root;
+	root.setProperty(OpacityPD, 0.5f);
+	int changed = 0;
+	root.connect(OpacityPD, [&changed](float) { ++changed; });
+	root.emit();
+	changed = 0;
+
+	root.changeProperty(OpacityPD, 0.505f);
+	root.emit();
+	ASSERT_EQ(changed, 0);
+	ASSERT_EQ(root.getProperty(OpacityPD), 0.5f);
+
+	root.changeProperty(OpacityPD, 0.6f);
+	root.emit();
+	ASSERT_EQ(changed, 1);
+	ASSERT_EQ(root.getProperty(OpacityPD), 0.6f);
+}
+
+TEST(ChangePolicyTest, epsilonPolicy_toAndFromNaN_signaled)
+{
+	ps::PropertyContainer root;
+	root.setProperty(OpacityPD, 5.f);
+	int changed = 0;
+	root.connect(OpacityPD, [&changed](float) { ++changed; });
+	root.emit();
+	changed = 0;
+
+	root.changeProperty(OpacityPD, std::numeric_limits<float>::quiet_NaN());
+	root.emit();
+	ASSERT_EQ(changed, 1);
+	ASSERT_TRUE(std::isnan(root.getProperty(OpacityPD).get()));
+
+	root.changeProperty(OpacityPD, std::numeric_limits<float>::quiet_NaN());
+	root.emit();
+	ASSERT_EQ(changed, 1);
+
+	root.changeProperty(OpacityPD, 5.f);
+	root.emit();
+	ASSERT_EQ(changed, 2);
+	ASSERT_EQ(root.getProperty(OpacityPD), 5.f);
+}
+
+TEST(ChangePolicyTest, alwaysChangedPolicy_sameValue_signaledAndMoved)
+{
+	ps::PropertyContainer root;
+	root.setProperty(BufferPD, std::vector<int>{ 1, 2, 3 });
+	int changed = 0;
+	root.connect(BufferPD, [&changed](const std::vector<int>&) { ++changed; });
+	root.emit();
+	changed = 0;
+
+	std::vector<int> buffer{ 1, 2, 3 };
+	const int* data = buffer.data();
+	root.changeProperty(BufferPD, std::move(buffer));
+	root.emit();
+	ASSERT_EQ(changed, 1);
+	ASSERT_EQ(root.getProperty(BufferPD).get().data(), data);
+}
+
+TEST(ChangePolicyTest, projectionPolicy_sameVersion_notSignaled)
+{
+	struct Mesh
+	{
+		int m_version = 0;
+		std::vector<float> m_vertices;
+	};
+	auto policy = ps::make_projection_change_policy<Mesh>([](const Mesh& mesh) { return mesh.m_version; });
+	ps::Property<Mesh> mesh;
+	mesh.setChangePolicy(&policy);
+	int changed = 0;
+	mesh += [&changed](const Mesh&) { ++changed; };
+
+	mesh.set(Mesh{ 0, { 1.f } });
+	ASSERT_EQ(changed, 0);
+	mesh.set(Mesh{ 1, { 1.f } });
+	ASSERT_EQ(changed, 1);
+	ASSERT_EQ(mesh.get().m_version, 1);
+}
@@ -2,6 +2,12 @@
 #include <cppproperties/PropertyContainer.h>
 #include <cppproperties/ProxyProperty.h>
 
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 //###########################################################################
 //#
 //#                    PropertyContainer Tests       
@@ -124,3 +130,257 @@ TEST(CppPropertiesTest, makeProxyProperty_copyContainer_copiedCorrectly)
 }
 
 
+
+//###########################################################################
+//#
+//#                    PropertyContainer Tests       
+//#						   Proxy Properties
+//#					   make_async_proxy_property
+//#
+//###########################################################################
+
+namespace
+{
+	//runs the submitted tasks only when asked to, so the tests are deterministic
+	struct ManualExecutor
+	{
+		std::vector<std::function<void()>> m_tasks;
+
+		template<typename FuncT>
+		void submit(FuncT&& func)
+		{
+			m_tasks.emplace_back(std::forward<FuncT>(func));
+		}
+		void runAll()
+		{
+			auto tasks = std::move(m_tasks);
+			m_tasks.clear();
+			for (auto& task : tasks)
+				task();
+		}
+	};
+
+	const ps::PropertyDescriptor<int> AsyncResultPD(0);
+}
+
+TEST(CppPropertiesTest, makeAsyncProxyProperty_resultReady_publishedAtEmit)
+{
+	ManualExecutor executor;
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 1);
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(AsyncResultPD, ps::make_async_proxy_property(executor, [](int i) { return i * 2; }, IntPD));
+	int observedValue = 0;
+	child.connectToVar(AsyncResultPD, observedValue);
+
+	root.changeProperty(IntPD, 5);
+	root.emit();
+	executor.runAll();
+	ASSERT_EQ(child.getProperty(AsyncResultPD), 0);
+
+	root.emit();
+	ASSERT_EQ(child.getProperty(AsyncResultPD), 10);
+	ASSERT_EQ(observedValue, 10);
+}
+
+TEST(CppPropertiesTest, makeAsyncProxyProperty_inputChangedAgain_staleResultDiscarded)
+{
+	ManualExecutor executor;
+	int invokeCount = 0;
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 1);
+	root.setProperty(AsyncResultPD, ps::make_async_proxy_property(executor, [&invokeCount](int i) { ++invokeCount; return i * 2; }, IntPD));
+	executor.runAll();
+	root.emit();
+	invokeCount = 0;
+
+	root.changeProperty(IntPD, 5);
+	root.emit();
+	root.changeProperty(IntPD, 7);
+	root.emit();
+	executor.runAll();
+	root.emit();
+
+	ASSERT_EQ(invokeCount, 1);
+	ASSERT_EQ(root.getProperty(AsyncResultPD), 14);
+	ASSERT_FALSE(root.getProxyProperty(AsyncResultPD) == nullptr);
+}
+
+TEST(CppPropertiesTest, makeAsyncProxyProperty_threadPool_publishedOnceReady)
+{
+	ps::ThreadPool threadPool(2);
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 3);
+	auto async = ps::make_async_proxy_property(threadPool, [](int i) { return i * 2; }, IntPD);
+	auto& proxy = *async;
+	root.setProperty(AsyncResultPD, std::move(async));
+
+	root.changeProperty(IntPD, 21);
+	root.emit();
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+	while (proxy.isPending() && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::yield();
+		root.emit();
+	}
+
+	ASSERT_FALSE(proxy.isPending());
+	ASSERT_EQ(root.getProperty(AsyncResultPD), 42);
+}
+
+//###########################################################################
+//#
+//#                    PropertyContainer Tests       
+//#						   Proxy Properties
+//#					   make_lazy_proxy_property
+//#
+//###########################################################################
+
+namespace
+{
+	const ps::PropertyDescriptor<int> LazyInputAPD(1);
+	const ps::PropertyDescriptor<int> LazyInputBPD(2);
+	const ps::PropertyDescriptor<int> LazySumPD(0);
+}
+
+TEST(CppPropertiesTest, makeLazyProxyProperty_severalInputsChanged_invokedOncePerEmit)
+{
+	int invokeCount = 0;
+	ps::PropertyContainer root;
+	root.setProperty(LazyInputAPD, 1);
+	root.setProperty(LazyInputBPD, 2);
+	root.setProperty(IntPD, 3);
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	auto sum = [&invokeCount](int a, int b, int c) { ++invokeCount; return a + b + c; };
+	child.setProperty(LazySumPD, ps::make_lazy_proxy_property(sum, LazyInputAPD, LazyInputBPD, IntPD));
+	int observedValue = 0;
+	child.connectToVar(LazySumPD, observedValue);
+	root.emit();
+	invokeCount = 0;
+
+	root.changeProperty(LazyInputAPD, 10);
+	root.changeProperty(LazyInputBPD, 20);
+	root.changeProperty(IntPD, 30);
+	root.emit();
+
+	ASSERT_EQ(invokeCount, 1);
+	ASSERT_EQ(observedValue, 60);
+	ASSERT_EQ(child.getProperty(LazySumPD), 60);
+}
+
+TEST(CppPropertiesTest, makeLazyProxyProperty_readBeforeOwnerEmitted_previousResult)
+{
+	int invokeCount = 0;
+	ps::PropertyContainer root;
+	root.setProperty(LazyInputAPD, 1);
+	root.setProperty(LazyInputBPD, 2);
+	auto lazy = ps::make_lazy_proxy_property([&invokeCount](int a, int b) { ++invokeCount; return a * b; }, LazyInputAPD, LazyInputBPD);
+	auto& proxy = *lazy;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(LazySumPD, std::move(lazy));
+	root.emit();
+	invokeCount = 0;
+
+	//the input B is emitted before the child, so the proxy is still stale when the value is read
+	bool wasStale = false;
+	int readValue = 0;
+	root.connect(LazyInputBPD, [&](int) {
+		wasStale = proxy.isStale();
+		readValue = child.getProperty(LazySumPD);
+	});
+	root.changeProperty(LazyInputAPD, 3);
+	root.changeProperty(LazyInputBPD, 4);
+	root.emit();
+
+	ASSERT_TRUE(wasStale);
+	ASSERT_EQ(readValue, 2);
+	ASSERT_FALSE(proxy.isStale());
+	ASSERT_EQ(invokeCount, 1);
+	ASSERT_EQ(child.getProperty(LazySumPD), 12);
+}
+
+TEST(CppPropertiesTest, makeLazyProxyProperty_functionThrows_previousResultKept)
+{
+	ps::PropertyContainer root;
+	root.setProperty(LazyInputAPD, 1);
+	auto lazy = ps::make_lazy_proxy_property([](int a) { if (a < 0) throw std::invalid_argument("negative"); return a; }, LazyInputAPD);
+	auto& proxy = *lazy;
+	root.setProperty(LazySumPD, std::move(lazy));
+	root.emit();
+
+	root.changeProperty(LazyInputAPD, -1);
+	root.emit();
+	ASSERT_EQ(root.getProperty(LazySumPD), 1);
+	ASSERT_TRUE(proxy.getException());
+
+	root.changeProperty(LazyInputAPD, 5);
+	root.emit();
+	ASSERT_EQ(root.getProperty(LazySumPD), 5);
+	ASSERT_FALSE(proxy.getException());
+}
+
+//###########################################################################
+//#
+//#                    PropertyContainer Tests       
+//#						   Proxy Properties
+//#					   make_memoized_proxy_property
+//#
+//###########################################################################
+
+namespace
+{
+	const ps::PropertyDescriptor<std::string> LanguagePD("en");
+	const ps::PropertyDescriptor<std::string> TranslationPD("");
+}
+
+TEST(CppPropertiesTest, makeMemoizedProxyProperty_toggleInputs_cachedResultReused)
+{
+	int invokeCount = 0;
+	ps::PropertyContainer root;
+	root.setProperty(LanguagePD, "en");
+	auto translate = [&invokeCount](const std::string& language) -> std::string { ++invokeCount; return language == "de" ? "Hallo" : "Hello"; };
+	auto memoized = ps::make_memoized_proxy_property(2, translate, LanguagePD);
+	auto& proxy = *memoized;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(TranslationPD, std::move(memoized));
+	root.emit();
+	invokeCount = 0;
+	const size_t missCount = proxy.getMissCount();
+
+	for (int i = 0; i < 3; ++i)
+	{
+		root.changeProperty(LanguagePD, "de");
+		root.emit();
+		ASSERT_EQ(child.getProperty(TranslationPD).get(), "Hallo");
+		root.changeProperty(LanguagePD, "en");
+		root.emit();
+		ASSERT_EQ(child.getProperty(TranslationPD).get(), "Hello");
+	}
+
+	//only the first switch to "de" is a cache miss, "en" was cached by the initial emit
+	ASSERT_EQ(invokeCount, 1);
+	ASSERT_EQ(proxy.getMissCount(), missCount + 1);
+	ASSERT_EQ(proxy.getHitCount(), 5u);
+}
+
+TEST(CppPropertiesTest, makeMemoizedProxyProperty_capacityExceeded_leastRecentlyUsedEvicted)
+{
+	ps::PropertyContainer root;
+	root.setProperty(IntPD, 0);
+	auto memoized = ps::make_memoized_proxy_property(2, [](int i) { return i * 2; }, IntPD);
+	auto& proxy = *memoized;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(AsyncResultPD, std::move(memoized));
+	root.emit();
+
+	for (int value : { 1, 2, 1, 3, 2 })
+	{
+		root.changeProperty(IntPD, value);
+		root.emit();
+		ASSERT_EQ(child.getProperty(AsyncResultPD), value * 2);
+	}
+
+	//2 was evicted by 3, 1 was used more recently than 2
+	ASSERT_EQ(proxy.getCacheSize(), 2u);
+	ASSERT_EQ(proxy.getHitCount(), 1u);
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <cppproperties/SharedPropertyPublisher.h>
+
+#ifndef _WIN32
+
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+//###########################################################################
+//#
+//#                    SharedProperty Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	struct Position
+	{
+		float m_x = 0.f;
+		float m_y = 0.f;
+		bool operator==(const Position& other) const { return m_x == other.m_x && m_y == other.m_y; }
+		bool operator!=(const Position& other) const { return !(*this == other); }
+	};
+	ps::PropertyDescriptor<int> SharedHealthPD(100, "shared.health");
+	ps::PropertyDescriptor<Position> SharedPositionPD(Position{}, "shared.position");
+
+	std::string segmentName()
+	{
+		return "/cppproperties_test_" + std::to_string(::getpid());
+	}
+
+	//fails to connect once the given number of connections is reached
+	class FailingConnectContainer : public ps::PropertyContainer
+	{
+	public:
+		template<typename T, typename FuncT>
+		size_t connect(const ps::PropertyDescriptor<T>& pd, FuncT&& func)
+		{
+			if (m_connectionsLeft-- == 0)
+				throw std::runtime_error("can't connect");
+			return ps::PropertyContainer::connect(pd, std::forward<FuncT>(func));
+		}
+		int m_connectionsLeft = 0;
+	};
+}
+
+TEST(SharedProperty, read_valuesUpdatedOnEmit)
+{
+	ps::PropertyContainer root;
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	root.setProperty(SharedHealthPD, 50);
+
+	ps::SharedPropertyPublisher<> publisher(segmentName(), child);
+	publisher.add(SharedHealthPD);
+	publisher.add(SharedPositionPD);
+	publisher.publish();
+
+	ps::SharedPropertyReader reader(segmentName());
+	EXPECT_TRUE(reader.isPublished());
+	auto health = reader.find<int>("shared.health");
+	auto position = reader.find<Position>("shared.position");
+	//the initial values are the ones the container sees
+	EXPECT_EQ(health.read(), 50);
+	EXPECT_EQ(position.read().m_x, 0.f);
+
+	const auto version = health.getVersion();
+	child.setProperty(SharedHealthPD, 20);
+	child.setProperty(SharedPositionPD, Position{ 1.f, 2.f });
+	EXPECT_EQ(health.read(), 50);
+	root.emit();
+	EXPECT_EQ(health.read(), 20);
+	EXPECT_EQ(position.read().m_y, 2.f);
+	EXPECT_NE(health.getVersion(), version);
+}
+
+TEST(SharedProperty, reader_invalidAccess_throws)
+{
+	ps::PropertyContainer root;
+	EXPECT_THROW(ps::SharedPropertyReader{ segmentName() }, std::runtime_error);
+	{
+		ps::SharedPropertyPublisher<> publisher(segmentName(), root);
+		publisher.add(SharedHealthPD);
+		publisher.publish();
+		ps::SharedPropertyReader reader(segmentName());
+		EXPECT_THROW((void)reader.find<int>("shared.unknown"), std::runtime_error);
+		EXPECT_THROW((void)reader.find<double>("shared.health"), std::runtime_error);
+	}
+	//the segment is removed with the publisher
+	EXPECT_THROW(ps::SharedPropertyReader{ segmentName() }, std::runtime_error);
+}
+
+TEST(SharedProperty, add_invalidName_throws)
+{
+	ps::PropertyContainer root;
+	ps::PropertyDescriptor<int> UnnamedPD(0);
+	ps::PropertyDescriptor<int> LongNamePD(0, std::string(ps::SharedPropertySegment::s_maxNameSize + 1, 'x'));
+	ps::SharedPropertyPublisher<> publisher(segmentName(), root);
+	EXPECT_THROW(publisher.add(UnnamedPD), std::invalid_argument);
+	EXPECT_THROW(publisher.add(LongNamePD), std::invalid_argument);
+}
+
+TEST(SharedProperty, publish_connectFails_segmentRemoved)
+{
+	FailingConnectContainer root;
+	root.m_connectionsLeft = 1;
+	ps::SharedPropertyPublisher<FailingConnectContainer> publisher(segmentName(), root);
+	publisher.add(SharedHealthPD);
+	publisher.add(SharedPositionPD);
+	EXPECT_THROW(publisher.publish(), std::runtime_error);
+	EXPECT_THROW(ps::SharedPropertyReader{ segmentName() }, std::runtime_error);
+
+	//nothing is left connected, so publishing can be retried
+	root.m_connectionsLeft = 2;
+	publisher.publish();
+	ps::SharedPropertyReader reader(segmentName());
+	EXPECT_EQ(reader.find<int>("shared.health").read(), 100);
+}
+
+TEST(SharedProperty, find_slotOutsideOfSegment_throws)
+{
+	ps::PropertyContainer root;
+	ps::SharedPropertyPublisher<> publisher(segmentName(), root);
+	publisher.add(SharedHealthPD);
+	publisher.publish();
+	//corrupts the offset of the slot
+	const int fd = ::shm_open(segmentName().c_str(), O_RDWR, 0);
+	ASSERT_GE(fd, 0);
+	const size_t slotInfoSize = sizeof(ps::SharedPropertySegment::Header) + sizeof(ps::SharedPropertySegment::SlotInfo);
+	void* data = ::mmap(nullptr, slotInfoSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	ASSERT_NE(data, MAP_FAILED);
+	auto* slotInfo = reinterpret_cast<ps::SharedPropertySegment::SlotInfo*>(static_cast<char*>(data) + sizeof(ps::SharedPropertySegment::Header));
+	slotInfo->m_offset = 1u << 20;
+	::munmap(data, slotInfoSize);
+
+	ps::SharedPropertyReader reader(segmentName());
+	EXPECT_THROW((void)reader.find<int>("shared.health"), std::runtime_error);
+}
+
+TEST(SharedProperty, destroyPublisher_readerKeepsLastValue)
+{
+	ps::PropertyContainer root;
+	root.setProperty(SharedHealthPD, 7);
+	auto publisher = std::make_unique<ps::SharedPropertyPublisher<>>(segmentName(), root);
+	publisher->add(SharedHealthPD);
+	publisher->publish();
+	ps::SharedPropertyReader reader(segmentName());
+	auto health = reader.find<int>("shared.health");
+	publisher.reset();
+	EXPECT_FALSE(reader.isPublished());
+	EXPECT_EQ(health.read(), 7);
+	//the signal of the publisher was disconnected
+	root.setProperty(SharedHealthPD, 8);
+	root.emit();
+	EXPECT_EQ(health.read(), 7);
+}
+
+#endif
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cppproperties/Snapshot.h>
+#include <cppproperties/ProxyProperty.h>
+
+#include <cstdio>
+
+//###########################################################################
+//#
+//#                    Snapshot Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	ps::PropertyDescriptor<int> LevelPD(0, "level");
+	ps::PropertyDescriptor<double> ScalePD(1., "scale");
+	ps::PropertyDescriptor<std::string> NamePD("", "name");
+	ps::PropertyDescriptor<std::vector<float>> WeightsPD(std::vector<float>{}, "weights");
+	ps::PropertyDescriptor<int> DoubledLevelPD(0, "doubledLevel");
+
+	ps::SnapshotSchema<> makeSchema()
+	{
+		ps::SnapshotSchema<> schema;
+		schema.add(LevelPD);
+		schema.add(ScalePD);
+		schema.add(NamePD);
+		schema.add(WeightsPD);
+		return schema;
+	}
+}
+
+TEST(SnapshotTest, saveAndLoad_hierarchy_propertiesRestored)
+{
+	auto schema = makeSchema();
+	ps::PropertyContainer root;
+	root.setProperty(LevelPD, 3);
+	root.setProperty(NamePD, "root");
+	root.setProperty(DoubledLevelPD, ps::make_proxy_property([](int level) { return 2 * level; }, LevelPD));
+	auto& child = root.addChildContainer<ps::PropertyContainer>();
+	child.setProperty(ScalePD, 0.5);
+	child.setProperty(WeightsPD, std::vector<float>{ 1.f, 2.f });
+	child.addChildContainer<ps::PropertyContainer>().setProperty(NamePD, "grandChild");
+
+	std::vector<char> snapshot;
+	schema.save(root, snapshot);
+
+	ps::PropertyContainer loaded;
+	schema.load(snapshot.data(), snapshot.size(), loaded);
+	ASSERT_EQ(loaded.getProperty(LevelPD), 3);
+	ASSERT_EQ(loaded.getProperty(NamePD).get(), "root");
+	//the proxy property isn't part of the snapshot
+	ASSERT_FALSE(loaded.hasProperty(DoubledLevelPD));
+	ASSERT_EQ(loaded.size(), 1u);
+	auto& loadedChild = *loaded[0];
+	ASSERT_EQ(loadedChild.getProperty(ScalePD), 0.5);
+	ASSERT_EQ(loadedChild.getProperty(WeightsPD).get(), (std::vector<float>{ 1.f, 2.f }));
+	ASSERT_EQ(loadedChild.getProperty(LevelPD), 3);
+	ASSERT_EQ(loadedChild[0]->getProperty(NamePD).get(), "grandChild");
+}
+
+TEST(SnapshotTest, loadFile_unknownDescriptor_skipped)
+{
+	auto schema = makeSchema();
+	ps::PropertyContainer root;
+	root.setProperty(LevelPD, 7);
+	root.setProperty(NamePD, "saved");
+	const std::string path = testing::TempDir() + "cppproperties_snapshot.bin";
+	schema.saveFile(root, path);
+
+	//a program that doesn't know the name PD anymore
+	ps::SnapshotSchema<> otherSchema;
+	otherSchema.add(LevelPD);
+	ps::PropertyContainer loaded;
+	otherSchema.loadFile(path, loaded);
+	std::remove(path.c_str());
+
+	ASSERT_EQ(loaded.getProperty(LevelPD), 7);
+	ASSERT_FALSE(loaded.hasProperty(NamePD));
+}
+
+TEST(SnapshotTest, load_truncatedSnapshot_throws)
+{
+	auto schema = makeSchema();
+	ps::PropertyContainer root;
+	root.setProperty(NamePD, "truncated");
+	std::vector<char> snapshot;
+	schema.save(root, snapshot);
+	snapshot.resize(snapshot.size() - 3);
+
+	ps::PropertyContainer loaded;
+	ASSERT_THROW(schema.load(snapshot.data(), snapshot.size(), loaded), std::runtime_error);
+}
+
+TEST(SnapshotTest, load_hugeDescriptorCount_throwsRuntimeError)
+{
+	auto schema = makeSchema();
+	std::vector<char> snapshot;
+	ps::PropertyContainer empty;
+	schema.save(empty, snapshot);
+	//the magic and the version are kept, the descriptor count claims more descriptors than the snapshot can hold
+	snapshot.resize(2 * sizeof(uint32_t));
+	const uint32_t descriptorCount = 0xFFFFFFFF;
+	snapshot.insert(snapshot.end(), reinterpret_cast<const char*>(&descriptorCount), reinterpret_cast<const char*>(&descriptorCount + 1));
+
+	ps::PropertyContainer loaded;
+	ASSERT_THROW(schema.load(snapshot.data(), snapshot.size(), loaded), std::runtime_error);
+}
+
+TEST(SnapshotTest, load_deeplyNestedSnapshot_throwsWithoutChangingRoot)
+{
+	auto schema = makeSchema();
+	schema.setMaxDepth(64);
+	//a crafted snapshot with a chain of 100000 containers
+	std::vector<char> snapshot;
+	ps::PropertyContainer empty;
+	schema.save(empty, snapshot);
+	snapshot.resize(snapshot.size() - 2 * sizeof(uint32_t));
+	const uint32_t level[2] = { 0, 1 };
+	for (int i = 0; i < 100000; ++i)
+		snapshot.insert(snapshot.end(), reinterpret_cast<const char*>(level), reinterpret_cast<const char*>(level + 2));
+
+	ps::PropertyContainer loaded;
+	loaded.setProperty(LevelPD, 1);
+	ASSERT_THROW(schema.load(snapshot.data(), snapshot.size(), loaded), std::runtime_error);
+	ASSERT_EQ(loaded.getProperty(LevelPD), 1);
+	ASSERT_EQ(loaded.size(), 0u);
+}
+
+TEST(SnapshotTest, load_corruptSnapshot_rootUntouched)
+{
+	auto schema = makeSchema();
+	ps::PropertyContainer root;
+	root.setProperty(LevelPD, 5);
+	root.addChildContainer<ps::PropertyContainer>().setProperty(NamePD, "child");
+	root.addChildContainer<ps::PropertyContainer>().setProperty(ScalePD, 2.);
+	std::vector<char> snapshot;
+	schema.save(root, snapshot);
+	//the last child claims a child that isn't part of the snapshot
+	snapshot[snapshot.size() - 4] = 1;
+
+	ps::PropertyContainer loaded;
+	loaded.setProperty(NamePD, "loaded");
+	ASSERT_THROW(schema.load(snapshot.data(), snapshot.size(), loaded), std::runtime_error);
+	ASSERT_FALSE(loaded.hasProperty(LevelPD));
+	ASSERT_EQ(loaded.getProperty(NamePD).get(), "loaded");
+	ASSERT_EQ(loaded.size(), 0u);
+
+	//the snapshot still loads once it's intact
+	snapshot[snapshot.size() - 4] = 0;
+	schema.load(snapshot.data(), snapshot.size(), loaded);
+	ASSERT_EQ(loaded.getProperty(LevelPD), 5);
+	ASSERT_EQ(loaded.size(), 2u);
+	ASSERT_EQ(loaded[0]->getProperty(NamePD).get(), "child");
+	ASSERT_EQ(loaded[1]->getProperty(ScalePD), 2.);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cppproperties/ProxyProperty.h>
+#include <cppproperties/StaticPropertyContainer.h>
+
+//###########################################################################
+//#
+//#                    StaticPropertyContainer Tests       
+//#
+//###########################################################################
+
+namespace
+{
+	const ps::PropertyDescriptor<int> HealthPD(100);
+	const ps::PropertyDescriptor<int> ArmorPD(0);
+	const ps::PropertyDescriptor<std::string> NamePD("Unnamed");
+	const ps::PropertyDescriptor<float> SpeedPD(1.f);
+
+	class Entity : public ps::StaticPropertyContainer<HealthPD, ArmorPD, NamePD>
+	{
+	};
+}
+
+TEST(StaticPropertyContainerTest, get_noValueSet_defaultValue)
+{
+	Entity entity;
+	ASSERT_EQ(entity.get<HealthPD>(), 100);
+	ASSERT_EQ(entity.get<ArmorPD>(), 0);
+	ASSERT_EQ(entity.get<NamePD>(), "Unnamed");
+	ASSERT_TRUE(entity.hasProperty(HealthPD));
+}
+
+TEST(StaticPropertyContainerTest, setAndChangeProperty_staticAndDynamicAccessAgree)
+{
+	Entity entity;
+	entity.set<HealthPD>(50);
+	entity.changeProperty(ArmorPD, 7);
+	entity.setProperty(NamePD, "Orc");
+	entity.setProperty(SpeedPD, 2.f);
+
+	ASSERT_EQ(entity.getProperty(HealthPD), 50);
+	ASSERT_EQ(entity.get<ArmorPD>(), 7);
+	ASSERT_EQ(entity[NamePD].get(), "Orc");
+	ASSERT_EQ(entity.getProperty(SpeedPD), 2.f);
+	//the dynamic interface of the base class sees the same values
+	const ps::PropertyContainer& base = entity;
+	ASSERT_EQ(base.getProperty(HealthPD), 50);
+	ASSERT_EQ(base.getProperty(ArmorPD), 7);
+}
+
+TEST(StaticPropertyContainerTest, hierarchy_childObservesStaticProperty_emitted)
+{
+	ps::PropertyContainer root;
+	auto& entity = root.addChildContainer<Entity>();
+	auto& child = entity.addChildContainer<ps::PropertyContainer>();
+	int observedHealth = 0;
+	child.connectToVar(HealthPD, observedHealth);
+
+	entity.set<HealthPD>(42);
+	root.emit();
+	ASSERT_EQ(observedHealth, 42);
+
+	child.changeProperty(HealthPD, 10);
+	root.emit();
+	ASSERT_EQ(entity.get<HealthPD>(), 10);
+	ASSERT_EQ(observedHealth, 10);
+}
+
+TEST(StaticPropertyContainerTest, copyConstructor_staticPropertiesCopied)
+{
+	Entity entity;
+	entity.set<HealthPD>(3);
+	entity.setProperty(SpeedPD, 4.f);
+
+	Entity copy(entity);
+	copy.set<HealthPD>(5);
+
+	ASSERT_EQ(entity.get<HealthPD>(), 3);
+	ASSERT_EQ(copy.get<HealthPD>(), 5);
+	ASSERT_EQ(copy.getProperty(HealthPD), 5);
+	ASSERT_EQ(copy.getProperty(SpeedPD), 4.f);
+}
+
+TEST(StaticPropertyContainerTest, removeAndProxyViaBaseInterface_staticPropertyKept)
+{
+	ps::PropertyContainer root;
+	auto& entity = root.addChildContainer<Entity>();
+	entity.set<HealthPD>(7);
+	ps::PropertyContainer& base = *root[0];
+
+	EXPECT_DEBUG_DEATH(base.removeProperty(HealthPD), "");
+	EXPECT_DEBUG_DEATH(base.setProperty(HealthPD, ps::make_proxy_property([](int armor) { return armor; }, ArmorPD)), "");
+
+	ASSERT_TRUE(base.hasProperty(HealthPD));
+	ASSERT_EQ(base.getProperty(HealthPD), 7);
+	ASSERT_EQ(entity.get<HealthPD>(), 7);
+}